@@ -0,0 +1,663 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	micro benchmarks of the simulation kernels and the sample simulators
+//
+
+#include <acnh.h>
+#include <chrono>
+#include <cstdarg>
+
+#include "methods.h"
+
+namespace layout1 {
+#include "layout1.cpp"
+}
+
+// timer
+// -----------------------------------------------------------------------------
+class stop_watch
+{
+	std::chrono::steady_clock::time_point	m_start;
+
+    public:
+	stop_watch() : m_start( std::chrono::steady_clock::now()) { }
+
+	double ns() const
+	{
+		return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - m_start ).count();
+	}
+};
+
+volatile unsigned	sink;		// keep the results alive
+
+// results
+//	with -m, "name<TAB>value<TAB>unit" of each result instead of the text for the people
+// -----------------------------------------------------------------------------
+bool	machine = false;
+
+void say( const char* fmt, ... )
+{
+	va_list	ap;
+
+	if ( machine ) return;
+	va_start( ap, fmt );
+	vprintf( fmt, ap );
+	va_end( ap );
+}
+
+void result( const char* name, double v, const char* unit )
+{
+	if ( machine ) printf( "%s\t%.3f\t%s\n", name, v, unit );
+}
+
+// cross(): bit-test kernel ( the former implementation ) vs table kernel
+// -----------------------------------------------------------------------------
+gene cross_bits( gene x, gene y, unsigned h )
+{
+	return (((( 0x80 & h ) ? 0x80 : 0x40 ) & x ) ? 0x80 : 0 ) |
+	       (((( 0x08 & h ) ? 0x80 : 0x40 ) & y ) ? 0x40 : 0 ) |
+	       (((( 0x40 & h ) ? 0x20 : 0x10 ) & x ) ? 0x20 : 0 ) |
+	       (((( 0x04 & h ) ? 0x20 : 0x10 ) & y ) ? 0x10 : 0 ) |
+	       (((( 0x20 & h ) ? 0x08 : 0x04 ) & x ) ? 0x08 : 0 ) |
+	       (((( 0x02 & h ) ? 0x08 : 0x04 ) & y ) ? 0x04 : 0 ) |
+	       (((( 0x10 & h ) ? 0x02 : 0x01 ) & x ) ? 0x02 : 0 ) |
+	       (((( 0x01 & h ) ? 0x02 : 0x01 ) & y ) ? 0x01 : 0 );
+}
+
+bool verify_cross()
+{
+	// the same random bits must make the same offspring
+	for ( unsigned x = 0; x < 256; ++x ) {
+		for ( unsigned y = 0; y < 256; ++y ) {
+			for ( unsigned h = 0; h < 256; ++h ) {
+				if ( cross_bits( x, y, h ) != cross( x, y, h )) {
+					fprintf( stderr, "cross: mismatch %02x x %02x by %02x\n", x, y, h );
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool verify_offspring()
+{
+	// the exact distribution and its sampler must agree with the enumeration of cross()
+	const offspring_table&	t = offspring_table::instance();
+
+	for ( unsigned x = 0; x < Genotypes; ++x ) {
+		for ( unsigned y = 0; y < Genotypes; ++y ) {
+			unsigned short	n[ Genotypes ] = { 0 };
+			unsigned short	s[ Genotypes ] = { 0 };
+
+			for ( unsigned h = 0; h < 256; ++h ) {
+				++n[ flower::flower_no( cross_bits( genotype_gene( x ), genotype_gene( y ), h )) ];
+				++s[ flower::flower_no( t.sample( genotype_gene( x ), genotype_gene( y ), h )) ];
+			}
+
+			offspring_distribution	d = offspring( Ro, genotype_gene( x ), genotype_gene( y ));
+
+			for ( unsigned k = 0; k < Genotypes; ++k ) {
+				if ( n[ k ] != d.genotype[ k ] || n[ k ] != s[ k ] ) {
+					fprintf( stderr, "offspring: mismatch %02x x %02x\n", genotype_gene( x ), genotype_gene( y ));
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+double distribution_error( gene x, gene y, unsigned n )
+{
+	// maximum relative error of the sampled offspring distribution from the exact one
+	unsigned	exact[ 256 ] = { 0 };
+	unsigned	count[ 256 ] = { 0 };
+	random_engine	e( 1 );
+	double		r = 0.0;
+
+	for ( unsigned h = 0; h < 256; ++h ) ++exact[ cross_bits( x, y, h ) ];
+	for ( unsigned i = 0; i < n; ++i ) ++count[ cross( x, y, e ) ];
+
+	for ( unsigned g = 0; g < 256; ++g ) {
+		if ( exact[ g ] ) {
+			double d = fabs( 1.0 * count[ g ] / n - exact[ g ] / 256.0 ) / ( exact[ g ] / 256.0 );
+			if ( r < d ) r = d;
+		} else if ( count[ g ] ) {
+			return 1.0;
+		}
+	}
+	return r;
+}
+
+void bench_cross( unsigned n )
+{
+	gene		pg[ 1024 ];
+	random_engine	e( 2 );
+	unsigned	s = 0;
+
+	for ( unsigned i = 0; i < 1024; ++i ) pg[ i ] = e.byte();
+
+	stop_watch	t0;
+	for ( unsigned i = 0; i < n; ++i ) s += cross_bits( pg[ i & 1023 ], pg[ ( i + 1 ) & 1023 ], rand() % 256 );
+	double		d0 = t0.ns();
+
+	stop_watch	t1;
+	for ( unsigned i = 0; i < n; ++i ) s += cross_bits( pg[ i & 1023 ], pg[ ( i + 1 ) & 1023 ], e() >> 56 );
+	double		d1 = t1.ns();
+
+	stop_watch	t2;
+	for ( unsigned i = 0; i < n; ++i ) s += cross( pg[ i & 1023 ], pg[ ( i + 1 ) & 1023 ], e );
+	double		d2 = t2.ns();
+
+	gene		r[ 8 ];
+	stop_watch	t3;
+	for ( unsigned i = 0; i < n; i += 8 ) {
+		cross( pg[ i & 1023 ], pg[ ( i + 1 ) & 1023 ], r, 8, e );
+		for ( unsigned j = 0; j < 8; ++j ) s += r[ j ];
+	}
+	double		d3 = t3.ns();
+
+	sink = s;
+
+	say( "cross: bit-test + rand()        %7.2f ns/op\n", d0 / n );
+	say( "cross: bit-test + random_engine %7.2f ns/op\n", d1 / n );
+	say( "cross: table + byte reservoir   %7.2f ns/op (x%.2f)\n", d2 / n, d0 / d2 );
+	say( "cross: table, 8 crosses/draw    %7.2f ns/op (x%.2f)\n", d3 / n, d0 / d3 );
+	result( "cross.bits_rand", d0 / n, "ns/op" );
+	result( "cross.bits_engine", d1 / n, "ns/op" );
+	result( "cross.table", d2 / n, "ns/op" );
+	result( "cross.table8", d3 / n, "ns/op" );
+}
+
+// flower::flower_no(): genes to the index of the color table
+// -----------------------------------------------------------------------------
+void bench_flower_no( unsigned n )
+{
+	gene		pg[ 1024 ];
+	random_engine	e( 6 );
+	unsigned	s = 0;
+
+	for ( unsigned i = 0; i < 1024; ++i ) pg[ i ] = e.byte();
+
+	stop_watch	t;
+	for ( unsigned i = 0; i < n; ++i ) s += flower::flower_no( pg[ i & 1023 ] ^ ( i >> 10 ));
+	double		d = t.ns();
+
+	sink = s;
+
+	say( "flower_no:                      %7.2f ns/op\n", d / n );
+	result( "flower_no", d / n, "ns/op" );
+}
+
+// daily process order: insertion sort by random keys ( the former implementation ) vs Fisher-Yates
+// -----------------------------------------------------------------------------
+template <unsigned N>
+class sorted_list
+{
+	unsigned	m_list[ N ];
+	int		m_keys[ N ];
+	unsigned	m_pos;
+
+    public:
+	sorted_list() : m_pos( 0 ) { }
+
+	void put( int k, unsigned c )
+	{
+		if ( m_pos < N ) {
+			bool	s = false;
+
+			for ( unsigned i = m_pos; 0 < i; --i ) {
+				if ( k < m_keys[ i - 1 ] ) {
+					m_keys[ i ] = m_keys[ i - 1 ];
+					m_list[ i ] = m_list[ i - 1 ];
+				} else {
+					m_keys[ i ] = k;
+					m_list[ i ] = c;
+					s = true;
+					break;
+				}
+			}
+			if ( !s ) {
+				m_keys[ 0 ] = k;
+				m_list[ 0 ] = c;
+			}
+			++m_pos;
+		}
+	}
+	unsigned operator[]( unsigned i ) const { return m_list[ i ]; }
+};
+
+template <unsigned R, unsigned C>
+struct bench_field : public flower_field<R,C>
+{
+	typedef flower_field<R,C>				super;
+	typedef typename flower_field<R,C>::random_list		random_list;
+
+	unsigned	m_prods;
+
+	bench_field() : flower_field<R,C>( "bench" ), m_prods( 0 ) { }
+
+	// roses on the checkered cells, hybrids are harvested every day
+	void recycle() override
+	{
+		super::recycle();
+		for ( unsigned r = 0; r < R; ++r ) {
+			for ( unsigned c = 0; c < C; ++c ) {
+				if (( r + c ) % 2 == 0 ) this->set( rose::create(( c % 3 ) ? gRdRose : gWhRose, 3 ), { r, c } );
+			}
+		}
+		m_prods = 0;
+	}
+	void harvest() override
+	{
+		for ( const coord<C>& c : super::m_generation ) {
+			if ( super::pull( c )) ++m_prods;
+		}
+	}
+};
+
+double shuffle_error( unsigned n )
+{
+	// maximum relative error of the frequencies of the 24 orders of 4 cells
+	typedef bench_field<1,4>::random_list	list;
+
+	unsigned	count[ 256 ] = { 0 };
+	random_engine	e( 3 );
+	double		r = 0.0;
+
+	for ( unsigned i = 0; i < n; ++i ) {
+		list		l;
+		unsigned	k = 0;
+
+		for ( unsigned c = 0; c < 4; ++c ) l.put( { 0, c } );
+		l.shuffle( e );
+		for ( const coord<4>& c : l ) k = k * 4 + c.c;
+		++count[ k ];
+	}
+	for ( unsigned k = 0; k < 256; ++k ) {
+		if ( count[ k ] ) {
+			double d = fabs( 24.0 * count[ k ] / n - 1.0 );
+			if ( r < d ) r = d;
+		}
+	}
+	return r;
+}
+
+void bench_shuffle( unsigned n )
+{
+	// full 5x19 field ( ff_initialHybrid_5 ), n / 100 days
+	const unsigned		R = 5;
+	const unsigned		C = 19;
+	const unsigned		days = n / 100;
+	random_engine		e( 4 );
+	unsigned		s = 0;
+
+	stop_watch	t0;
+	for ( unsigned d = 0; d < days; ++d ) {
+		sorted_list<R * C>	l;
+
+		for ( unsigned i = 0; i < R * C; ++i ) l.put( e() >> 33, i );
+		s += l[ 0 ];
+	}
+	double		d0 = t0.ns();
+
+	stop_watch	t1;
+	for ( unsigned d = 0; d < days; ++d ) {
+		bench_field<R,C>::random_list	l;
+
+		for ( unsigned r = 0; r < R; ++r ) {
+			for ( unsigned c = 0; c < C; ++c ) l.put( { r, c } );
+		}
+		l.shuffle( e );
+		s += l.begin()->index();
+	}
+	double		d1 = t1.ns();
+
+	sink = s;
+
+	say( "shuffle: 5x19 insertion sort    %7.2f ns/day\n", d0 / days );
+	say( "shuffle: 5x19 Fisher-Yates      %7.2f ns/day (x%.2f)\n", d1 / days, d0 / d1 );
+	result( "shuffle.sort.5x19", d0 / days, "ns/day" );
+	result( "shuffle.fisher_yates.5x19", d1 / days, "ns/day" );
+}
+
+// neighborhood queries: per-cell scan vs bitboards on a 5x19 field
+// -----------------------------------------------------------------------------
+unsigned run_field( bool bitboard, unsigned days, double& ns )
+{
+	bench_field<5,19>	f;
+	random_engine		e( 5 );
+
+	ff_base::bitboard( bitboard );
+	f.bind( &e );
+	f.recycle();
+
+	stop_watch	t;
+	for ( unsigned d = 0; d < days; ++d ) {
+		f.hydrate( 5 );
+		f.daily_refresh();
+		f.harvest();
+	}
+	ns = t.ns();
+
+	ff_base::bitboard( true );
+
+	return f.m_prods;
+}
+
+bool bench_field_queries( unsigned n )
+{
+	const unsigned	days = n / 100;
+	double		d0, d1;
+	unsigned	p0 = run_field( false, days, d0 );
+	unsigned	p1 = run_field( true, days, d1 );
+
+	if ( p0 != p1 ) {
+		fprintf( stderr, "field: bitboard %u hybrids != scan %u hybrids\n", p1, p0 );
+		return false;
+	}
+	say( "field: 5x19 scan                %7.2f ns/day, %u hybrids\n", d0 / days, p0 );
+	say( "field: 5x19 bitboard            %7.2f ns/day (x%.2f)\n", d1 / days, d0 / d1 );
+	result( "field.scan.5x19", d0 / days, "ns/day" );
+	result( "field.bitboard.5x19", d1 / days, "ns/day" );
+
+	return true;
+}
+
+// runtime-sized field: ff_dynamic vs flower_field<5,19> ( scan and bitboards )
+// -----------------------------------------------------------------------------
+struct bench_dfield : public ff_dynamic
+{
+	unsigned	m_prods;
+
+	bench_dfield( unsigned rows, unsigned cols ) : ff_dynamic( "bench", rows, cols ), m_prods( 0 ) { }
+
+	// the same flowers as bench_field<R,C>
+	void recycle() override
+	{
+		ff_dynamic::recycle();
+		for ( unsigned r = 0; r < m_rows; ++r ) {
+			for ( unsigned c = 0; c < m_cols; ++c ) {
+				if (( r + c ) % 2 == 0 ) set( rose::create(( c % 3 ) ? gRdRose : gWhRose, 3 ), r, c );
+			}
+		}
+		m_prods = 0;
+	}
+	void harvest() override
+	{
+		for ( unsigned i : m_generation ) {
+			if ( pull( i )) ++m_prods;
+		}
+	}
+};
+
+bool bench_dynamic( unsigned n )
+{
+	const unsigned	days = n / 100;
+	double		d0, d1;
+	unsigned	p0 = run_field( false, days, d0 );
+	unsigned	p1 = run_field( true, days, d1 );
+	bench_dfield	f( 5, 19 );
+	random_engine	e( 5 );
+
+	f.bind( &e );
+	f.recycle();
+
+	stop_watch	t;
+	for ( unsigned d = 0; d < days; ++d ) {
+		f.hydrate( 5 );
+		f.daily_refresh();
+		f.harvest();
+	}
+	double		d2 = t.ns();
+
+	if ( f.m_prods != p0 || p1 != p0 ) {
+		fprintf( stderr, "field: ff_dynamic %u hybrids != flower_field %u hybrids\n", f.m_prods, p0 );
+		return false;
+	}
+	say( "field: 5x19 ff_dynamic          %7.2f ns/day (x%.2f of scan, x%.2f of bitboard)\n",
+	     d2 / days, d0 / d2, d1 / d2 );
+	result( "field.dynamic.5x19", d2 / days, "ns/day" );
+
+	return true;
+}
+
+// daily_refresh(), planting_space() and plant_queue::plant() by field sizes
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C>
+struct kernel_field : public bench_field<R,C>
+{
+	typedef flower_field<R,C>	base;
+
+	typename base::plant_queue	m_pq;
+	std::vector<coord<C>>		m_order;	// of m_pq
+
+	kernel_field() : m_pq( this, { } )
+	{
+		for ( unsigned r = 0; r < R; ++r ) {
+			for ( unsigned c = 0; c < C; ++c ) {
+				if (( r + c ) % 2 == 1 ) m_order.push_back( { r, c } );
+			}
+		}
+		for ( const coord<C>& c : m_order ) m_pq.set_order( c );
+	}
+
+	// planting_space() of every cell by the bitboard of the occupied cells, after daily_refresh()
+	// which makes the neighbor tables
+	unsigned spaces( unsigned n )
+	{
+		typename base::board	occupied;
+		unsigned		s = 0;
+
+		for ( unsigned i = 0; i < R * C; ++i ) {
+			if ( base::m_field[ i ] ) occupied.set( base::bit( { i / C, i % C } ));
+		}
+		for ( unsigned i = 0; i < n; ++i ) {
+			if ( coord<C>* p = base::planting_space( { ( i / C ) % R, i % C }, occupied )) s += p->c;
+		}
+		return s;
+	}
+
+	// plant the empty cells from the queue, then pull them again
+	unsigned plants( unsigned n )
+	{
+		const flower	f = rose::create( gWhRose, 0 );
+		unsigned	s = 0;
+
+		for ( unsigned i = 0; i < n; i += m_pq.size()) {
+			m_pq.open();
+			while ( m_pq.put( f ));
+			s += m_pq.plant();
+			for ( const coord<C>& c : m_order ) base::pull( c );
+		}
+		return s;
+	}
+};
+
+template <unsigned R, unsigned C>
+void bench_kernels( unsigned n )
+{
+	const unsigned		days = std::max( 1u, n / 100 / ( R * C / 15 ));
+	kernel_field<R,C>	f;
+	random_engine		e( 7 );
+	char			nm[ 64 ];
+
+	f.bind( &e );
+	f.recycle();
+
+	stop_watch	t0;
+	for ( unsigned d = 0; d < days; ++d ) {
+		f.hydrate( 5 );
+		f.daily_refresh();
+		f.harvest();
+	}
+	double		d0 = t0.ns();
+
+	f.recycle();
+	f.daily_refresh();
+
+	stop_watch	t1;
+	sink = f.spaces( n / 10 );
+	double		d1 = t1.ns();
+
+	f.recycle();
+
+	stop_watch	t2;
+	sink = f.plants( n / 10 );
+	double		d2 = t2.ns();
+
+	say( "daily_refresh: %2ux%-2u            %7.2f ns/day, %7.2f ns/cell\n", R, C, d0 / days, d0 / days / ( R * C ));
+	say( "planting_space: %2ux%-2u           %7.2f ns/op\n", R, C, d1 / ( n / 10 ));
+	say( "plant_queue::plant: %2ux%-2u       %7.2f ns/flower\n", R, C, d2 / ( n / 10 ));
+	snprintf( nm, sizeof( nm ), "daily_refresh.%ux%u", R, C );
+	result( nm, d0 / days, "ns/day" );
+	snprintf( nm, sizeof( nm ), "planting_space.%ux%u", R, C );
+	result( nm, d1 / ( n / 10 ), "ns/op" );
+	snprintf( nm, sizeof( nm ), "plant_queue.plant.%ux%u", R, C );
+	result( nm, d2 / ( n / 10 ), "ns/flower" );
+}
+
+// layout studies: one trial at a time vs trials in lockstep lanes
+// -----------------------------------------------------------------------------
+struct lane_tally
+{
+	unsigned	m_prods = 0;
+
+	void tally( const flower& ) { ++m_prods; }
+};
+
+template <unsigned L>
+void bench_lockstep( unsigned days, double scalar_ns, unsigned scalar_prods )
+{
+	bench_field<5,19>	f;
+	lane_tally		h;
+
+	f.recycle();
+
+	ff_lockstep<5,19,L>	e( f );
+
+	e.seed( 5, 0 );
+
+	stop_watch	t;
+	e.run( days, 5, h );
+	double		d = t.ns();
+
+	char	nm[ 64 ];
+
+	say( "lockstep: 5x19 %2u lanes         %7.2f ns/lane-day (x%.2f), %.3f hybrids/day (scalar %.3f)\n",
+	     L, d / days / L, scalar_ns / d * L, 1.0 * h.m_prods / days / L, 1.0 * scalar_prods / days );
+	snprintf( nm, sizeof( nm ), "lockstep.5x19.%u", L );
+	result( nm, d / days / L, "ns/lane-day" );
+}
+
+void bench_lockstep( unsigned n )
+{
+	const unsigned	days = n / 100;
+	double		d0;
+	unsigned	p0 = run_field( true, days, d0 );
+
+	bench_lockstep<8>( days, d0, p0 );
+	bench_lockstep<16>( days, d0, p0 );
+	bench_lockstep<32>( days, d0, p0 );
+}
+
+// sample simulators: fixed-seed regression trials, one thread
+// -----------------------------------------------------------------------------
+void bench_method( const method& m, const sim_options& opt, unsigned trials )
+{
+	simulator*	s = m.create();
+	char		nm[ 64 ];
+	unsigned long	days = 0;
+
+	s->set_options( opt );
+
+	stop_watch	t;
+	for ( unsigned i = 0; i < trials; ++i ) days += s->trial( i );
+	double		d = t.ns();
+
+	delete s;
+
+	say( "%-8s %5u trials              %7.2f trials/s, %.3f days/trial\n", m.name, trials, trials * 1e9 / d, 1.0 * days / trials );
+	snprintf( nm, sizeof( nm ), "%s.trials", m.name );
+	result( nm, trials * 1e9 / d, "trials/s" );
+}
+
+void bench_methods( unsigned n )
+{
+	const unsigned	trials = std::max( 1u, n / 20000 );
+	sim_options	opt;
+
+	opt.seed = 1;
+	for ( const char* name : { "bn", "gr", "grx", "ph" } ) bench_method( *find_method( name ), opt, trials );
+
+	// layout1: 9 layouts of 5x7, 1000 days
+	layout1::LO_simulator_2		lo( 1000, opt );
+
+	stop_watch	t;
+	lo.simulate();
+	double		d = t.ns();
+
+	say( "layout1  5x7 9 layouts           %7.2f days/s\n", 1000 * 1e9 / d );
+	result( "layout1.days", 1000 * 1e9 / d, "days/s" );
+
+	// the same layouts by ff_dynamic
+	layout1::LO_dsimulator		dlo( 5, 7, 1000, opt );
+
+	stop_watch	td;
+	dlo.simulate();
+	double		dd = td.ns();
+
+	say( "layout1  5x7 9 layouts dynamic   %7.2f days/s (x%.2f)\n", 1000 * 1e9 / dd, d / dd );
+	result( "layout1.dynamic.days", 1000 * 1e9 / dd, "days/s" );
+}
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	unsigned	n = 10000000;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'n': n = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'm': machine = true; break;
+				default:
+					fprintf( stderr, "Usage: %s [-n iterations][-m]\n", argv[ 0 ] );
+					exit( 1 );
+			}
+		}
+	}
+	if ( n < 1000 ) {
+		// the days and the sizes of the kernel loops are n / 100 and n / 10
+		fprintf( stderr, "Error: -n %u, the iterations are at least 1000\n", n );
+		exit( 1 );
+	}
+
+	if ( !verify_cross()) return 1;
+	say( "cross: table kernel == bit-test kernel for all parents and random bits\n" );
+	if ( !verify_offspring()) return 1;
+	say( "offspring: exact distribution == enumeration of cross() for all genotypes\n" );
+	say( "cross: Rd4 x Rd4 distribution error %.4f%% in %u samples\n",
+	     100.0 * distribution_error( 0x54, 0x54, n ), n );
+
+	say( "shuffle: 24 orders of 4 cells, frequency error %.4f%% in %u samples\n",
+	     100.0 * shuffle_error( n ), n );
+
+	bench_cross( n );
+	bench_flower_no( n );
+	bench_shuffle( n );
+	if ( !bench_field_queries( n )) return 1;
+	if ( !bench_dynamic( n )) return 1;
+	bench_kernels<5,3>( n );
+	bench_kernels<5,19>( n );
+	bench_kernels<11,19>( n );
+	bench_lockstep( n );
+	bench_methods( n );
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	paired comparison of the methods by common random numbers
+//
+
+#include <acnh.h>
+
+#include "methods.h"
+
+// statistics of the paired differences ( Welford )
+// -----------------------------------------------------------------------------
+class paired_stat
+{
+	unsigned	m_n;
+	double		m_mean;
+	double		m_m2;
+
+    public:
+	paired_stat() : m_n( 0 ), m_mean( 0.0 ), m_m2( 0.0 ) { }
+
+	void add( double x )
+	{
+		double	d = x - m_mean;
+
+		++m_n;
+		m_mean += d / m_n;
+		m_m2   += d * ( x - m_mean );
+	}
+	double mean() const { return m_mean; }
+	double var() const { return ( 1 < m_n ) ? m_m2 / ( m_n - 1 ) : 0.0; }
+	double half_width() const { return ( 1 < m_n ) ? 1.96 * sqrt( var() / m_n ) : HUGE_VAL; }
+};
+
+// Comparison
+//	every method runs the trial t with the random streams of ( seed, t, field id ), then the
+//	fields of the same stage draw the same numbers while they breed alike, and the differences
+//	of the steps are paired.
+// -----------------------------------------------------------------------------
+class comparison
+{
+	std::vector<const method*>	m_methods;
+	std::vector<step_stat>		m_steps;	// [ k ]: steps of the method k
+	std::vector<paired_stat>	m_diff;		// [ k ]: steps of the method k - steps of the method 0
+	unsigned			m_n;
+
+	const sim_options&		m_opt;
+	const visitor			m_visitor;
+
+	static const unsigned		Batch = 1000;			// trials between the checks of --ci
+	static const unsigned		MaxTrials = 10000000;
+
+	// run the trials [ b, e ) of all methods, s[ ( t - b ) * K + k ]: steps of the method k
+	void run( unsigned b, unsigned e, unsigned jobs, std::vector<unsigned>& s )
+	{
+		const unsigned		K = m_methods.size();
+		std::atomic<unsigned>	next( b );
+		std::vector<std::thread>	threads;
+
+		s.assign(( e - b ) * K, 0 );
+
+		for ( unsigned j = 0; j < jobs; ++j ) {
+			threads.emplace_back( [&]() {
+				std::vector<simulator*>	sims;
+
+				for ( const method* m : m_methods ) {
+					simulator*	p = m->create();
+
+					p->set_visitor( m_visitor );
+					p->set_options( m_opt );
+					sims.push_back( p );
+				}
+				for ( unsigned t; ( t = next.fetch_add( 1 )) < e; ) {
+					for ( unsigned k = 0; k < K; ++k ) s[ ( t - b ) * K + k ] = sims[ k ]->trial( m_opt.trial + t );
+				}
+				for ( simulator* p : sims ) delete p;
+			});
+		}
+		for ( std::thread& t : threads ) t.join();
+	}
+
+	bool converged() const
+	{
+		if ( m_n < Batch ) return false;
+		for ( unsigned k = 1; k < m_diff.size(); ++k ) {
+			if ( m_opt.ci < m_diff[ k ].half_width()) return false;
+		}
+		return true;
+	}
+
+    public:
+	comparison( const std::vector<const method*>& m, const sim_options& opt, visitor v )
+		: m_methods( m ), m_steps( m.size()), m_diff( m.size()), m_n( 0 ), m_opt( opt ), m_visitor( v )
+	{ }
+
+	void regression( unsigned n, unsigned jobs )
+	{
+		// with --ci, trials are added by Batch until all the differences reach the half-width
+		const unsigned		K = m_methods.size();
+		const bool		adaptive = ( 0.0 < m_opt.ci );
+		std::vector<unsigned>	s;
+
+		if ( adaptive ) n = MaxTrials;
+		if ( jobs == 0 ) jobs = std::thread::hardware_concurrency();
+
+		fprintf( stderr, "Info: seed %llu, trials %u..\n", m_opt.seed, m_opt.trial );
+
+		while ( m_n < n ) {
+			unsigned	e = ( adaptive && m_n + Batch < n ) ? m_n + Batch : n;
+
+			run( m_n, e, jobs, s );
+
+			for ( unsigned i = 0; i < e - m_n; ++i ) {
+				for ( unsigned k = 0; k < K; ++k ) {
+					m_steps[ k ].add( s[ i * K + k ] );
+					if ( 0 < k ) m_diff[ k ].add( 1.0 * s[ i * K + k ] - s[ i * K ] );
+				}
+			}
+			m_n = e;
+
+			if ( adaptive && converged()) break;
+		}
+	}
+
+	void stat() const
+	{
+		printf( "%u paired traials, visitors = %u\n", m_n, m_visitor );
+		for ( unsigned k = 0; k < m_methods.size(); ++k ) {
+			printf( "  %-8s", m_methods[ k ]->name );
+			m_steps[ k ].print( "" );
+		}
+		for ( unsigned k = 1; k < m_methods.size(); ++k ) {
+			// the half-width if the methods were run by independent random numbers
+			double	iw = 1.96 * sqrt(( m_steps[ 0 ].sigma() * m_steps[ 0 ].sigma() +
+						   m_steps[ k ].sigma() * m_steps[ k ].sigma()) / m_n );
+			double	pw = m_diff[ k ].half_width();
+
+			printf( "  %s - %s: %+f +- %f days at 95%% ( independent runs +- %f, %.1fx trials )\n",
+				m_methods[ k ]->name, m_methods[ 0 ]->name, m_diff[ k ].mean(), pw, iw,
+				( 0.0 < pw ) ? iw * iw / pw / pw : 0.0 );
+		}
+	}
+};
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	sim_options			opt;
+	unsigned			visitor = 0;
+	unsigned			repeats = 1000;
+	unsigned			jobs    = 1;
+	std::vector<const method*>	m;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'r': repeats = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'j': jobs    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
+				default:
+					fprintf( stderr, "Usage: %s [-v visitors][-r repeats][-j jobs]%s method method ...\n", argv[ 0 ], sim_options::usage());
+					fprintf( stderr, "       method: bn, bn_lite, ph, gr, grx\n" );
+					return -1;
+			}
+		} else if ( const method* p = find_method( argv[ i ] )) {
+			m.push_back( p );
+		} else {
+			fprintf( stderr, "Error: unknown method %s\n", argv[ i ] );
+			return -1;
+		}
+	}
+	if ( m.size() < 2 ) {
+		fprintf( stderr, "Error: two or more methods are required\n" );
+		return -1;
+	}
+
+	comparison	c( m, opt, visitor );
+
+	c.regression( repeats, jobs );
+	c.stat();
+
+	return 0;
+}
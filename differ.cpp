@@ -0,0 +1,529 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	differential test of the simulation engines by the same scenarios
+//
+
+#include "methods.h"
+#include "pipeline.h"
+#include "reference/reference.h"
+
+namespace layout1 {
+#include "layout1.cpp"
+}
+namespace layout2 {
+#include "layout2.cpp"
+}
+
+// Scenarios
+//	the layouts of layout1.cpp ( White Roses ) and layout2.cpp ( Purple and Orange Roses ) in
+//	5x7 fields of mature roses watered every day, and the stage graphs of the methods, each
+//	engine runs the same trials of them.
+// -----------------------------------------------------------------------------
+const unsigned	LayoutWidth = 7;
+const unsigned	Block = 8;		// trials of a layout sample ( the lanes of lockstep8 )
+
+typedef flower_field<5,LayoutWidth>		layout_field;
+typedef ref::flower_field<5,LayoutWidth>	ref_field;
+
+struct layout_case
+{
+	const char*	name;
+	layout_field*	( *create )();
+	ref_field*	( *reference )();	// the same layout on the frozen engine
+	void		( *count )( const layout_field* f, unsigned& prods, unsigned& clones, unsigned& targets );
+	gene		target;			// pu002 of layout1, or121 of layout2
+	int		pattern;		// of layout1::patterns for ff_dlayout, -1 if none
+};
+
+// a layout of layout1.cpp, or of layout2.cpp with the roses X and Y
+template <typename B, typename F>
+B* make() { return new F(); }
+
+template <typename B, typename F, gene X, gene Y>
+B* make() { return new F( X, Y ); }
+
+// harvests of a layout field ( ff_layout of layout1.cpp or layout2.cpp )
+template <typename L>
+void harvests_of( const layout_field* f, unsigned& prods, unsigned& clones, unsigned& targets )
+{
+	const L*	p = static_cast<const L*>( f );
+
+	prods   = p->prods();
+	clones  = p->clones();
+	targets = p->targets();
+}
+
+const unsigned	W = LayoutWidth;
+const gene	gOr = layout2::gOr110;
+const gene	gPu = layout2::gPu012;
+const gene	gPu002 = 0xC0;
+const gene	gOr121 = layout2::gOr121;
+
+typedef layout1::ff_layout<W>	layout1_field;
+typedef layout2::ff_layout<W>	layout2_field;
+
+const layout_case	layouts[] = {
+	{ "layout 8",   make<layout_field, layout1::ff_layout8<W>>,   make<ref_field, ref::layout1::ff_layout8<W>>,   harvests_of<layout1_field>, gPu002, 0 },
+	{ "layout 9",   make<layout_field, layout1::ff_layout9<W>>,   make<ref_field, ref::layout1::ff_layout9<W>>,   harvests_of<layout1_field>, gPu002, 1 },
+	{ "layout 10",  make<layout_field, layout1::ff_layout10<W>>,  make<ref_field, ref::layout1::ff_layout10<W>>,  harvests_of<layout1_field>, gPu002, 2 },
+	{ "layout 11",  make<layout_field, layout1::ff_layout11<W>>,  make<ref_field, ref::layout1::ff_layout11<W>>,  harvests_of<layout1_field>, gPu002, 3 },
+	{ "layout 12O", make<layout_field, layout1::ff_layout12O<W>>, make<ref_field, ref::layout1::ff_layout12O<W>>, harvests_of<layout1_field>, gPu002, 4 },
+	{ "layout 12H", make<layout_field, layout1::ff_layout12H<W>>, make<ref_field, ref::layout1::ff_layout12H<W>>, harvests_of<layout1_field>, gPu002, 5 },
+	{ "layout 13",  make<layout_field, layout1::ff_layout13<W>>,  make<ref_field, ref::layout1::ff_layout13<W>>,  harvests_of<layout1_field>, gPu002, 6 },
+	{ "layout 7X",  make<layout_field, layout1::ff_layout7X<W>>,  make<ref_field, ref::layout1::ff_layout7X<W>>,  harvests_of<layout1_field>, gPu002, 7 },
+	{ "layout 8X",  make<layout_field, layout1::ff_layout8X<W>>,  make<ref_field, ref::layout1::ff_layout8X<W>>,  harvests_of<layout1_field>, gPu002, 8 },
+
+	{ "layout2 7N", make<layout_field, layout2::ff_layout7<W>, gOr, gPu>,  make<ref_field, ref::layout2::ff_layout7<W>, gOr, gPu>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 7R", make<layout_field, layout2::ff_layout7<W>, gPu, gOr>,  make<ref_field, ref::layout2::ff_layout7<W>, gPu, gOr>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 XN", make<layout_field, layout2::ff_layoutX<W>, gOr, gPu>,  make<ref_field, ref::layout2::ff_layoutX<W>, gOr, gPu>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 XR", make<layout_field, layout2::ff_layoutX<W>, gPu, gOr>,  make<ref_field, ref::layout2::ff_layoutX<W>, gPu, gOr>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 8",  make<layout_field, layout2::ff_layout8<W>, gOr, gPu>,  make<ref_field, ref::layout2::ff_layout8<W>, gOr, gPu>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 9N", make<layout_field, layout2::ff_layout9<W>, gOr, gPu>,  make<ref_field, ref::layout2::ff_layout9<W>, gOr, gPu>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 9R", make<layout_field, layout2::ff_layout9<W>, gPu, gOr>,  make<ref_field, ref::layout2::ff_layout9<W>, gPu, gOr>,  harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 LN", make<layout_field, layout2::ff_layout10<W>, gOr, gPu>, make<ref_field, ref::layout2::ff_layout10<W>, gOr, gPu>, harvests_of<layout2_field>, gOr121, -1 },
+	{ "layout2 LR", make<layout_field, layout2::ff_layout10<W>, gPu, gOr>, make<ref_field, ref::layout2::ff_layout10<W>, gPu, gOr>, harvests_of<layout2_field>, gOr121, -1 },
+};
+
+const char* const	stage_graphs[] = { "bn", "grx" };
+
+// outcomes of a scenario by an engine
+struct sample
+{
+	std::vector<double>	days;		// completion days of each trial ( methods )
+	std::vector<double>	harvests;	// harvests of each trial ( methods ) or Block trials ( layouts )
+	unsigned long long	clones;
+	unsigned long long	prods;
+	unsigned long long	targets;	// hybrids of the target genotype ( layouts )
+
+	sample() : clones( 0 ), prods( 0 ), targets( 0 ) { }
+};
+
+// harvests and clones of a method trial by its events
+class event_tally : public trace_sink
+{
+    public:
+	unsigned long long	harvests = 0;
+	unsigned long long	clones = 0;
+	unsigned long long	prods = 0;
+
+	void put( const char*, const trace_event& e ) override
+	{
+		if ( e.kind == trace_event::Harvest ) ++harvests;
+		if ( e.kind == trace_event::Clone ) ++clones;
+		if ( e.kind == trace_event::Clone || e.kind == trace_event::Cross ) ++prods;
+	}
+};
+
+// Engines
+//	the reference is the frozen baseline ( reference/reference.h ) with its own cross(), flower
+//	objects and process order, so the engines under test agree with it by the distributions
+//	and not by the draws. an engine under test implements the same I/F, and returns false for
+//	the scenarios which it does not support.
+// -----------------------------------------------------------------------------
+class engine
+{
+    public:
+	virtual ~engine() { }
+	virtual const char* name() const = 0;
+
+	// blocks x Block trials of days
+	virtual bool layout( const layout_case& c, unsigned long long seed, unsigned blocks, unsigned days, visitor v, sample& s ) = 0;
+
+	// trials of the method until its terminate_reg()
+	virtual bool method( const char* name, unsigned long long seed, unsigned trials, visitor v, sample& s ) = 0;
+};
+
+class scalar_engine : public engine
+{
+	const char*	m_name;
+	bool		m_bitboard;
+
+    public:
+	scalar_engine( const char* n, bool bitboard ) : m_name( n ), m_bitboard( bitboard ) { }
+
+	const char* name() const override { return m_name; }
+
+	bool layout( const layout_case& c, unsigned long long seed, unsigned blocks, unsigned days, visitor v, sample& s ) override
+	{
+		ff_base::bitboard( m_bitboard );
+		for ( unsigned b = 0; b < blocks; ++b ) {
+			unsigned	h = 0;
+
+			for ( unsigned t = b * Block; t < ( b + 1 ) * Block; ++t ) {
+				layout_field*	f = c.create();
+				random_engine	e;
+
+				e.seed( seed, t );
+				f->bind( &e );
+				for ( unsigned d = 0; d < days; ++d ) {
+					f->harvest();
+					f->plant();
+					f->hydrate( v );
+					f->daily_refresh();
+				}
+				f->harvest();
+
+				unsigned	prods, clones, targets;
+
+				c.count( f, prods, clones, targets );
+				h         += prods;
+				s.clones  += clones;
+				s.prods   += prods;
+				s.targets += targets;
+				delete f;
+			}
+			s.harvests.push_back( h );
+		}
+		ff_base::bitboard( true );
+
+		return true;
+	}
+
+	bool method( const char* name, unsigned long long seed, unsigned trials, visitor v, sample& s ) override
+	{
+		ff_base::bitboard( m_bitboard );
+		run_trials( find_method( name )->create(), seed, trials, v, s );
+		ff_base::bitboard( true );
+
+		return true;
+	}
+
+	// trials of the simulator p, then p is deleted
+	static void run_trials( simulator* p, unsigned long long seed, unsigned trials, visitor v, sample& s )
+	{
+		sim_options	opt;
+		event_tally	tl;
+
+		opt.seed = seed;
+		p->set_options( opt );
+		p->set_visitor( v );
+		p->set_sink( &tl );
+		for ( unsigned t = 0; t < trials; ++t ) {
+			unsigned long long	h = tl.harvests;
+
+			s.days.push_back( p->trial( t ));
+			s.harvests.push_back( tl.harvests - h );
+		}
+		s.clones = tl.clones;
+		s.prods  = tl.prods;
+		delete p;
+	}
+};
+
+// the frozen baseline engine, the reference of the others
+class reference_engine : public engine
+{
+    public:
+	const char* name() const override { return "reference"; }
+
+	bool layout( const layout_case& c, unsigned long long seed, unsigned blocks, unsigned days, visitor v, sample& s ) override
+	{
+		const ref::tally	t0 = ref::ref_tally;
+
+		for ( unsigned b = 0; b < blocks; ++b ) {
+			unsigned long long	h = ref::ref_tally.prods;
+
+			for ( unsigned t = b * Block; t < ( b + 1 ) * Block; ++t ) {
+				random_engine	e;
+
+				e.seed( seed, t );
+				ref::bind( &e );
+
+				ref_field*	f = c.reference();
+
+				for ( unsigned d = 0; d < days; ++d ) {
+					f->harvest();
+					f->plant();
+					f->hydrate( v );
+					f->daily_refresh();
+				}
+				f->harvest();
+				delete f;
+				ref::flower::clear_pool();
+			}
+			s.harvests.push_back( ref::ref_tally.prods - h );
+		}
+		s.clones  = ref::ref_tally.clones - t0.clones;
+		s.prods   = ref::ref_tally.prods - t0.prods;
+		s.targets = ref::ref_tally.genotype[ flower::flower_no( c.target ) ] - t0.genotype[ flower::flower_no( c.target ) ];
+
+		return true;
+	}
+
+	bool method( const char* name, unsigned long long seed, unsigned trials, visitor v, sample& s ) override
+	{
+		if      ( strcmp( name, "bn" ) == 0 )  run_trials<ref::bn::BN_simulator>( seed, trials, v, s );
+		else if ( strcmp( name, "grx" ) == 0 ) run_trials<ref::grx::GR_simulator>( seed, trials, v, s );
+		else					return false;
+
+		return true;
+	}
+
+    private:
+	template <typename S>
+	static void run_trials( unsigned long long seed, unsigned trials, visitor v, sample& s )
+	{
+		ref::trial_of<S>*	p = new ref::trial_of<S>();
+		const ref::tally	t0 = ref::ref_tally;
+
+		p->set_visitor( v );
+		for ( unsigned t = 0; t < trials; ++t ) {
+			random_engine		e( seed, t );
+			unsigned long long	h = ref::ref_tally.harvests;
+
+			s.days.push_back( p->trial( e ));
+			s.harvests.push_back( ref::ref_tally.harvests - h );
+		}
+		s.clones = ref::ref_tally.clones - t0.clones;
+		s.prods  = ref::ref_tally.prods - t0.prods;
+		delete p;
+	}
+};
+
+// the stage graphs by the pipeline files ( pipelines/*.pipe ) of the methods
+class pipeline_engine : public engine
+{
+    public:
+	const char* name() const override { return "pipeline"; }
+
+	bool layout( const layout_case&, unsigned long long, unsigned, unsigned, visitor, sample& ) override { return false; }
+
+	bool method( const char* name, unsigned long long seed, unsigned trials, visitor v, sample& s ) override
+	{
+		std::string	path = std::string( "pipelines/" ) + name + ".pipe";
+		PL_simulator*	p = PL_simulator::from_file( path.c_str());
+
+		if ( !p ) exit( 1 );
+		scalar_engine::run_trials( p, seed, trials, v, s );
+
+		return true;
+	}
+};
+
+class dynamic_engine : public engine
+{
+    public:
+	const char* name() const override { return "dynamic"; }
+
+	bool layout( const layout_case& c, unsigned long long seed, unsigned blocks, unsigned days, visitor v, sample& s ) override
+	{
+		if ( c.pattern < 0 ) return false;	// layout1 only
+
+		for ( unsigned b = 0; b < blocks; ++b ) {
+			unsigned	h = 0;
+
+			for ( unsigned t = b * Block; t < ( b + 1 ) * Block; ++t ) {
+				layout1::ff_dlayout	f( layout1::patterns[ c.pattern ], 5, LayoutWidth );
+				random_engine		e;
+
+				e.seed( seed, t );
+				f.bind( &e );
+				for ( unsigned d = 0; d < days; ++d ) {
+					f.harvest();
+					f.plant();
+					f.hydrate( v );
+					f.daily_refresh();
+				}
+				f.harvest();
+				h         += f.prods();
+				s.clones  += f.clones();
+				s.prods   += f.prods();
+				s.targets += f.targets();
+			}
+			s.harvests.push_back( h );
+		}
+
+		return true;
+	}
+
+	bool method( const char*, unsigned long long, unsigned, visitor, sample& ) override { return false; }
+};
+
+class lockstep_engine : public engine
+{
+	struct lane_count
+	{
+		unsigned	target;		// flower::flower_no() of the target
+		unsigned	prods = 0;
+		unsigned	clones = 0;
+		unsigned	targets = 0;
+
+		lane_count( gene g ) : target( flower::flower_no( g )) { }
+
+		void tally( const flower& f )
+		{
+			++prods;
+			if ( f.is_clone()) ++clones;
+			if ( flower::flower_no( f.get_gene()) == target ) ++targets;
+		}
+	};
+
+    public:
+	const char* name() const override { return "lockstep8"; }
+
+	bool layout( const layout_case& c, unsigned long long seed, unsigned blocks, unsigned days, visitor v, sample& s ) override
+	{
+		layout_field*	f = c.create();
+
+		for ( unsigned b = 0; b < blocks; ++b ) {
+			ff_lockstep<5,LayoutWidth,Block>	e( *f );
+			lane_count				h( c.target );
+
+			e.seed( seed, b * Block );
+			e.run( days, v, h );
+			s.harvests.push_back( h.prods );
+			s.clones  += h.clones;
+			s.prods   += h.prods;
+			s.targets += h.targets;
+		}
+		delete f;
+
+		return true;
+	}
+
+	bool method( const char*, unsigned long long, unsigned, visitor, sample& ) override { return false; }
+};
+
+// Tests
+// -----------------------------------------------------------------------------
+double ks_test( std::vector<double> a, std::vector<double> b, double& d )
+{
+	// two-sample Kolmogorov-Smirnov, p-value by the asymptotic distribution
+	std::sort( a.begin(), a.end());
+	std::sort( b.begin(), b.end());
+
+	const double	na = a.size(), nb = b.size();
+	size_t		i = 0, j = 0;
+
+	d = 0.0;
+	while ( i < a.size() && j < b.size()) {
+		double	x = std::min( a[ i ], b[ j ] );
+
+		while ( i < a.size() && a[ i ] <= x ) ++i;
+		while ( j < b.size() && b[ j ] <= x ) ++j;
+		d = std::max( d, fabs( i / na - j / nb ));
+	}
+
+	double	ne = na * nb / ( na + nb );
+	double	l  = ( sqrt( ne ) + 0.12 + 0.11 / sqrt( ne )) * d;
+	double	p  = 0.0;
+
+	for ( int k = 1; k <= 100; ++k ) p += (( k % 2 ) ? 2.0 : -2.0 ) * exp( -2.0 * k * k * l * l );
+
+	return ( l < 0.3 ) ? 1.0 : std::min( 1.0, std::max( 0.0, p ));
+}
+
+double proportion_test( unsigned long long x1, unsigned long long n1, unsigned long long x2, unsigned long long n2 )
+{
+	// chi-square of the 2x2 table ( df 1 ), p-value
+	double	p = 1.0 * ( x1 + x2 ) / ( n1 + n2 );
+
+	if ( n1 == 0 || n2 == 0 || p <= 0.0 || 1.0 <= p ) return 1.0;
+
+	double	e1 = n1 * p, e2 = n2 * p;
+	double	chi2 = ( x1 - e1 ) * ( x1 - e1 ) / e1 + ( x2 - e2 ) * ( x2 - e2 ) / e2 +
+		       (( n1 - x1 ) - ( n1 - e1 )) * (( n1 - x1 ) - ( n1 - e1 )) / ( n1 - e1 ) +
+		       (( n2 - x2 ) - ( n2 - e2 )) * (( n2 - x2 ) - ( n2 - e2 )) / ( n2 - e2 );
+
+	return erfc( sqrt( chi2 / 2.0 ));
+}
+
+// compare the sample of an engine with the reference, true if no divergence
+bool compare( const char* scenario, const sample& r, const sample& s, double alpha )
+{
+	if ( r.days == s.days && r.harvests == s.harvests && r.clones == s.clones && r.prods == s.prods && r.targets == s.targets ) {
+		printf( "  %-12s identical\n", scenario );
+		return true;
+	}
+
+	double	dd = 0.0, dh = 0.0;
+	double	pd = r.days.empty() ? 1.0 : ks_test( r.days, s.days, dd );
+	double	ph = ks_test( r.harvests, s.harvests, dh );
+	double	pc = proportion_test( r.clones, r.prods, s.clones, s.prods );
+	double	pt = proportion_test( r.targets, r.prods, s.targets, s.prods );
+	bool	ok = ( alpha <= pd && alpha <= ph && alpha <= pc && alpha <= pt );
+
+	printf( "  %-12s", scenario );
+	if ( !r.days.empty()) printf( " days D %.4f p %.3f,", dd, pd );
+	printf( " harvests D %.4f p %.3f, clones %.3f%% / %.3f%% p %.3f", dh, ph,
+		100.0 * r.clones / std::max( r.prods, 1ull ), 100.0 * s.clones / std::max( s.prods, 1ull ), pc );
+	if ( r.days.empty()) {
+		printf( ", targets %.3f%% / %.3f%% p %.3f", 100.0 * r.targets / std::max( r.prods, 1ull ),
+			100.0 * s.targets / std::max( s.prods, 1ull ), pt );
+	}
+	printf( " %s\n", ok ? "ok" : "DIVERGED" );
+
+	return ok;
+}
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	unsigned long long	seed    = 1;
+	unsigned		trials  = 2000;
+	unsigned		days    = 100;
+	unsigned		visitor = 0;
+	double			alpha   = 0.001;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'r': trials  = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'd': days    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'a': alpha   = strtod( argv[ ++i ], nullptr ); break;
+				case 'q': trials  = 200; break;
+				case '-': if ( i + 1 < argc && strcmp( argv[ i ], "--seed" ) == 0 ) {
+						  seed = strtoull( argv[ ++i ], nullptr, 0 );
+						  break;
+					  }
+					  // fall through
+				default:
+					fprintf( stderr, "Usage: %s [-r trials][-d days][-v visitors][-a alpha][-q][--seed n]\n", argv[ 0 ] );
+					return -1;
+			}
+		}
+	}
+
+	reference_engine	reference;
+	scalar_engine		scan( "scan", false );
+	scalar_engine		bitboard( "bitboard", true );
+	dynamic_engine		dynamic;
+	lockstep_engine		lockstep;
+	pipeline_engine		pipeline;
+	engine* const		engines[] = { &scan, &bitboard, &dynamic, &lockstep, &pipeline };
+	const unsigned		blocks = ( trials + Block - 1 ) / Block;
+	const unsigned		NL = sizeof( layouts ) / sizeof( layouts[ 0 ] );
+	const unsigned		NM = sizeof( stage_graphs ) / sizeof( stage_graphs[ 0 ] );
+	std::vector<sample>	rl( NL ), rm( NM );
+	bool			ok = true;
+
+	printf( "differ: seed %llu, %u trials ( layouts: %u days ), alpha %g\n", seed, trials, days, alpha );
+
+	// the reference samples by the other seed, for the independent samples of the tests
+	for ( unsigned k = 0; k < NL; ++k ) reference.layout( layouts[ k ], ~seed, blocks, days, visitor, rl[ k ] );
+	for ( unsigned k = 0; k < NM; ++k ) reference.method( stage_graphs[ k ], ~seed, trials, visitor, rm[ k ] );
+
+	for ( engine* e : engines ) {
+		printf( "%s vs %s\n", e->name(), reference.name());
+		for ( unsigned k = 0; k < NL; ++k ) {
+			sample	s;
+
+			if ( !e->layout( layouts[ k ], seed, blocks, days, visitor, s )) continue;
+			ok = compare( layouts[ k ].name, rl[ k ], s, alpha ) && ok;
+		}
+		for ( unsigned k = 0; k < NM; ++k ) {
+			sample	s;
+
+			if ( !e->method( stage_graphs[ k ], seed, trials, visitor, s )) continue;
+			ok = compare( stage_graphs[ k ], rm[ k ], s, alpha ) && ok;
+		}
+	}
+	printf( "differ: %s\n", ok ? "passed" : "FAILED" );
+
+	return ok ? 0 : 1;
+}
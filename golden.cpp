@@ -0,0 +1,260 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	golden results of the sample simulators and the offspring of cross() ( make check )
+//
+
+#include "methods.h"
+
+namespace reprod   {
+#include "reprod.cpp"
+}
+namespace pairprod {
+#include "pairprod.cpp"
+}
+
+// Golden results
+//	the averages documented in README.md, each run checks that the 99.7% confidence
+//	interval of its average ( +- 3 sigma / sqrt( n )) reaches the documented band.
+// -----------------------------------------------------------------------------
+struct golden
+{
+	const char*	name;
+	double		lo;		// documented band of the average
+	double		hi;
+	unsigned	trials;
+	step_stat	( *run )( unsigned long long seed, unsigned trials );
+};
+
+step_stat run_method( const char* name, unsigned long long seed, unsigned trials )
+{
+	simulator*	s = find_method( name )->create();
+	sim_options	opt;
+	step_stat	st;
+
+	opt.seed = seed;
+	s->set_options( opt );
+	for ( unsigned t = 0; t < trials; ++t ) st.add( s->trial( t ));
+	delete s;
+
+	return st;
+}
+
+step_stat run_reprod( unsigned long long seed, unsigned trials )
+{
+	reprod::FR_simulator	s( 1 );
+	sim_options		opt;
+	step_stat		st;
+
+	opt.seed = seed;
+	s.set_options( opt );
+	for ( unsigned t = 0; t < trials; ++t ) st.add( s.trial( t ));
+
+	return st;
+}
+
+step_stat run_pairprod( bool pair, unsigned long long seed, unsigned trials )
+{
+	pairprod::FP_simulator	s( 100, 1000 );
+	sim_options		opt;
+
+	opt.seed = seed;
+	s.set_options( opt );
+	for ( unsigned t = 0; t < trials; ++t ) s.trial( t );
+
+	return pair ? s.pair() : s.solo();
+}
+
+const golden	goldens[] = {
+	{ "bn",        69.0,  70.0,  10000, []( unsigned long long s, unsigned n ) { return run_method( "bn", s, n ); } },
+	{ "bn_lite",   59.0,  60.0,  10000, []( unsigned long long s, unsigned n ) { return run_method( "bn_lite", s, n ); } },
+	{ "ph",        94.0,  95.0,  10000, []( unsigned long long s, unsigned n ) { return run_method( "ph", s, n ); } },
+	{ "gr",        63.0,  64.0,  10000, []( unsigned long long s, unsigned n ) { return run_method( "gr", s, n ); } },
+	{ "grx",       53.0,  54.0,  10000, []( unsigned long long s, unsigned n ) { return run_method( "grx", s, n ); } },
+	{ "reprod",    6.727, 6.727, 100000, []( unsigned long long s, unsigned n ) { return run_reprod( s, n ); } },
+	{ "pair solo", 337.0, 338.0, 2000,  []( unsigned long long s, unsigned n ) { return run_pairprod( false, s, n ); } },
+	{ "pair pair", 486.0, 486.0, 2000,  []( unsigned long long s, unsigned n ) { return run_pairprod( true, s, n ); } },
+};
+
+// gr without clone(), regression() must not share it among the jobs
+class serial_gr : public gr::GR_simulator
+{
+    public:
+	simulator* clone() const override { return nullptr; }
+};
+
+bool check_serial( unsigned long long seed, unsigned n, unsigned jobs )
+{
+	// regression( n, jobs ) of serial_gr is the same as regression( n, 1 ), the reports of
+	// the regressions are discarded
+	step_stat	st[ 2 ];
+	unsigned	j[ 2 ] = { 1, jobs };
+	sim_options	opt;
+	FILE*		null = fopen( "/dev/null", "w" );
+	int		out  = dup( fileno( stdout ));
+	int		err  = dup( fileno( stderr ));
+
+	opt.seed = seed;
+	fflush( stdout );
+	fflush( stderr );
+	dup2( fileno( null ), fileno( stdout ));
+	dup2( fileno( null ), fileno( stderr ));
+	for ( unsigned k = 0; k < 2; ++k ) {
+		serial_gr	s;
+
+		s.set_options( opt );
+		s.regression( n, j[ k ] );
+		st[ k ] = s.total();
+	}
+	fflush( stdout );
+	fflush( stderr );
+	dup2( out, fileno( stdout ));
+	dup2( err, fileno( stderr ));
+	close( out );
+	close( err );
+	fclose( null );
+
+	bool	same = ( st[ 0 ].count() == st[ 1 ].count() && st[ 0 ].min() == st[ 1 ].min() && st[ 0 ].max() == st[ 1 ].max() &&
+			 st[ 0 ].mean() == st[ 1 ].mean() && st[ 0 ].sigma() == st[ 1 ].sigma());
+
+	printf( "check: no clone() %u trials, average %8.3f by 1 job, %8.3f by %u jobs %s\n",
+		n, st[ 0 ].mean(), st[ 1 ].mean(), jobs, same ? "ok" : "NG" );
+
+	return same;
+}
+
+// chi-square test of cross() by the Mendelian ratios
+//	each allele of the offspring comes from either allele of the parent by 1/2, then
+//	the genotype of a locus is ( x alleles ) x ( y alleles ) independently of the other loci.
+// -----------------------------------------------------------------------------
+void mendelian( gene x, gene y, double p[ Genotypes ] )
+{
+	// P( dominant allele from x ) = ( dominant alleles of x ) / 2 at each locus
+	for ( unsigned k = 0; k < Genotypes; ++k ) {
+		double		q = 1.0;
+		unsigned	n = k;
+
+		for ( int l = 3; 0 <= l; --l ) {
+			unsigned	a  = ( x >> ( 2 * l )) & 3;
+			unsigned	b  = ( y >> ( 2 * l )) & 3;
+			double		px = (( a & 1 ) + ( a >> 1 )) / 2.0;
+			double		py = (( b & 1 ) + ( b >> 1 )) / 2.0;
+			unsigned	c  = ( n / ( l == 3 ? 27 : l == 2 ? 9 : l == 1 ? 3 : 1 )) % 3;
+
+			q *= ( c == 2 ) ? px * py : ( c == 0 ) ? ( 1 - px ) * ( 1 - py ) : px * ( 1 - py ) + ( 1 - px ) * py;
+		}
+		p[ k ] = q;
+	}
+}
+
+double chi2_critical( unsigned df, double z )
+{
+	// Wilson-Hilferty approximation of the upper quantile at the normal deviate z
+	double	a = 2.0 / ( 9.0 * df );
+
+	return df * pow( 1.0 - a + z * sqrt( a ), 3.0 );
+}
+
+bool check_cross( unsigned pairs, unsigned n )
+{
+	// random pairs of the rose genotypes, n offspring each, at the significance 1e-4 per pair
+	random_engine	e( 11 );
+	unsigned	failed = 0;
+	double		worst = 0.0;
+
+	for ( unsigned i = 0; i < pairs; ++i ) {
+		gene		x = genotype_gene( e.below( Genotypes ));
+		gene		y = genotype_gene( e.below( Genotypes ));
+		double		p[ Genotypes ];
+		unsigned	count[ Genotypes ] = { 0 };
+		double		chi2 = 0.0;
+		unsigned	df = 0;
+
+		mendelian( x, y, p );
+		for ( unsigned j = 0; j < n; ++j ) ++count[ flower::flower_no( cross( x, y, e )) ];
+
+		for ( unsigned k = 0; k < Genotypes; ++k ) {
+			if ( 0.0 < p[ k ] ) {
+				double	d = count[ k ] - n * p[ k ];
+
+				chi2 += d * d / ( n * p[ k ] );
+				++df;
+			} else if ( count[ k ] ) {
+				printf( "check: cross %02x x %02x made an impossible genotype %u\n", x, y, k );
+				return false;
+			}
+		}
+		if ( 1 < df ) {
+			double	c = chi2_critical( df - 1, 3.719 );
+
+			if ( worst < chi2 / c ) worst = chi2 / c;
+			if ( c < chi2 ) {
+				printf( "check: cross %02x x %02x chi-square %.2f > %.2f ( df %u )\n", x, y, chi2, c, df - 1 );
+				++failed;
+			}
+		}
+	}
+	printf( "check: cross() %u pairs x %u offspring, chi-square / critical <= %.3f %s\n",
+		pairs, n, worst, failed ? "NG" : "ok" );
+
+	return failed == 0;
+}
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	unsigned long long	seed  = 1;
+	unsigned		jobs  = 0;
+	unsigned		scale = 1;		// divides the trials ( -q )
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'j': jobs  = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'q': scale = 10; break;
+				case '-': if ( i + 1 < argc && strcmp( argv[ i ], "--seed" ) == 0 ) {
+						  seed = strtoull( argv[ ++i ], nullptr, 0 );
+						  break;
+					  }
+					  // fall through
+				default:
+					fprintf( stderr, "Usage: %s [-j jobs][-q][--seed n]\n", argv[ 0 ] );
+					return -1;
+			}
+		}
+	}
+	if ( jobs == 0 ) jobs = std::thread::hardware_concurrency();
+
+	// the cases run in parallel, then the results are printed in the order of the table
+	const unsigned			N = sizeof( goldens ) / sizeof( goldens[ 0 ] );
+	std::vector<step_stat>		st( N );
+	std::atomic<unsigned>		next( 0 );
+	std::vector<std::thread>	threads;
+
+	for ( unsigned j = 0; j < jobs && j < N; ++j ) {
+		threads.emplace_back( [&]() {
+			for ( unsigned k; ( k = next.fetch_add( 1 )) < N; ) st[ k ] = goldens[ k ].run( seed, goldens[ k ].trials / scale );
+		});
+	}
+	bool	ok = check_cross( 200, 20000 / scale );
+
+	for ( std::thread& t : threads ) t.join();
+
+	for ( unsigned k = 0; k < N; ++k ) {
+		const golden&	g  = goldens[ k ];
+		double		m  = st[ k ].mean();
+		double		w  = 3.0 * st[ k ].sigma() / sqrt( st[ k ].count());
+		bool		in = ( g.lo - w <= m && m <= g.hi + w );
+
+		printf( "check: %-9s %6u trials, average %8.3f +- %6.3f, sigma %7.3f ( expected %g..%g ) %s\n",
+			g.name, st[ k ].count(), m, w, st[ k ].sigma(), g.lo, g.hi, in ? "ok" : "NG" );
+		ok = ok && in;
+	}
+	ok = check_serial( seed, 1000, 4 ) && ok;
+	printf( "check: %s\n", ok ? "passed" : "FAILED" );
+
+	return ok ? 0 : 1;
+}
@@ -12,6 +12,7 @@ class GR_simulator : public simulator
 {
 	unsigned		m_fmax;
 	unsigned		m_firstBlue;
+	unsigned		m_units;	// peak of the field units in the trial
 
 	ff_initialHybrid_2	m_f1;
 	ff_initialHybrid_2	m_f2;
@@ -26,7 +27,7 @@ class GR_simulator : public simulator
 
     public:
 	GR_simulator()
-		: m_fmax( 0 ), m_firstBlue( 0 ),
+		: m_fmax( 0 ), m_firstBlue( 0 ), m_units( 0 ),
 		  m_f1( "1: Wh_ x Wh_ -> Pu1" ),			// 25%
 		  m_f2( "2: Rd_ x Rd_ -> Bk2" ),			// 25%
 		  m_f3( "3: Pu1 x Bk2 -> Rd3", Pu, Bk ),		// 100%
@@ -59,15 +60,45 @@ class GR_simulator : public simulator
 	bool terminate_reg();
 	void print();
 
+	simulator* clone() const override { return new GR_simulator(); }
+	void merge( const simulator& s ) override
+	{
+		unsigned n = static_cast<const GR_simulator&>( s ).m_fmax;
+
+		if ( m_fmax < n ) m_fmax = n;
+	}
+	bool save( FILE* fp ) const override { return fwrite( &m_fmax, sizeof( m_fmax ), 1, fp ) == 1; }
+	bool load( FILE* fp ) override { return fread( &m_fmax, sizeof( m_fmax ), 1, fp ) == 1; }
+	void save_state( snapshot& s ) const override
+	{
+		simulator::save_state( s );
+		s.put( m_firstBlue );
+		s.put( m_units );
+	}
+	void load_state( snapshot& s ) override
+	{
+		simulator::load_state( s );
+		s.get( m_firstBlue );
+		s.get( m_units );
+	}
+
 	unsigned maxFieldUnits() const { return m_fmax; }
 	unsigned firstBlue() const { return m_firstBlue; }
 
+	void record( trial_record& r ) const override
+	{
+		r.first_blue  = ( m_fB.count() != 0 || m_fX.count() != 0 ) ? m_step : 0;
+		r.field_units = m_units;
+	}
+
     private:
 	unsigned usingFields() const;
 };
 
 void GR_simulator::initialize()
 {
+	m_units = 0;
+
 	while ( m_f1.put( rose::create( gWhRose ))) ;
 	while ( m_f2.put( rose::create( gRdRose ))) ;
 	while ( m_f4.put( rose::create( gYeRose ))) ;
@@ -101,6 +132,7 @@ bool GR_simulator::terminate_reg()
 	unsigned n = usingFields();
 
 	if ( m_fmax < n ) m_fmax = n;
+	if ( m_units < n ) m_units = n;
 
 	return 0 < m_fB.count() || 0 < m_fX.count();
 }
@@ -138,16 +170,17 @@ void GR_simulator::print()
 	if ( m_fX.count() != 0 ) m_fX.print();
 }
 
+#ifndef ACNH_NO_MAIN
 //
 // main
 //
 // -----------------------------------------------------------------------------
 int main( int argc, char** argv )
 {
-        std::srand( std::time(nullptr) );
-
+        sim_options    opt;
         unsigned        visitor = 0;
         unsigned        repeats = 0;
+        unsigned        jobs    = 1;
 
         for ( int i = 1; i < argc; ++i ) {
                 if ( *argv[ i ] == '-' ) {
@@ -155,8 +188,11 @@ int main( int argc, char** argv )
                                 case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
 				case 's':
                                 case 'r': repeats = strtoul( argv[ ++i ], nullptr, 0 ); break;
+                                case 'j': jobs    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+                                case '-': if ( opt.parse( argc, argv, i )) break;
+                                          // fall through
                                 default:
-                                        fprintf( stderr, "Usage %s [-v visitors][-r repeats]\n", argv[ 0 ] );
+                                        fprintf( stderr, "Usage %s [-v visitors][-r repeats][-j jobs]%s\n", argv[ 0 ], sim_options::usage());
                                         return -1;
                         }
                 }
@@ -165,19 +201,22 @@ int main( int argc, char** argv )
         GR_simulator    s;
 
         s.set_visitor( visitor );
+        s.set_options( opt );
 
-        if ( repeats == 0 ) {
+        if ( 0 < opt.forks ) {
+                s.branch( opt.fork_day, opt.forks, jobs );
+        } else if ( repeats == 0 && opt.ci == 0.0 ) {
                 unsigned        n = s.simulate();
 
                 printf( "\nGuaranteed Hybrid Red Method: %u steps, maximum %u field units used.\n",
 			n, s.maxFieldUnits());
                 printf( "       first blue rose in %u steps\n", s.firstBlue());
         } else {
-                s.regression( repeats );
+                repeats = s.regression( repeats, jobs );
                 printf( "\nGuaranteed Hybrid Red Method: %u regressions, maximum %u field units used.\n",
 			repeats, s.maxFieldUnits());
         }
 
         return 0;
 }
-
+#endif // ACNH_NO_MAIN
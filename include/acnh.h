@@ -20,32 +20,157 @@
 //	along with this program. If not, see <http://www.gnu.org/licenses/>.
 //
 
+#ifndef ACNH_H
+#define ACNH_H
+
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
 #include <ctime>
 #include <cmath>
 #include <cassert>
 #include <string>
 #include <initializer_list>
 #include <utility>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <unistd.h>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+#include <immintrin.h>
+#endif
 #include <pctl/plist.h>
 
+// random number engine (xoshiro256**), owned by each simulator
+// -----------------------------------------------------------------------------
+class random_engine
+{
+	unsigned long long	m_s[ 4 ];
+	unsigned long long	m_bytes;	// reservoir of byte(), one draw serves 8 crosses
+	unsigned		m_nbytes;
+
+	static unsigned long long rotl( unsigned long long x, int k ) { return ( x << k ) | ( x >> ( 64 - k )); }
+	static unsigned long long splitmix( unsigned long long& x )
+	{
+		unsigned long long z = ( x += 0x9E3779B97F4A7C15ull );
+
+		z = ( z ^ ( z >> 30 )) * 0xBF58476D1CE4E5B9ull;
+		z = ( z ^ ( z >> 27 )) * 0x94D049BB133111EBull;
+		return z ^ ( z >> 31 );
+	}
+
+    public:
+	random_engine( unsigned long long seed = 0, unsigned long long trial = 0 ) { this->seed( seed, trial ); }
+
+	// the independent stream for each trial of the same seed
+	void seed( unsigned long long seed, unsigned long long trial = 0 )
+	{
+		unsigned long long x = seed ^ ( 0xD1B54A32D192ED03ull * ( trial + 1 ));
+
+		for ( unsigned i = 0; i < 4; ++i ) m_s[ i ] = splitmix( x );
+		m_bytes  = 0;
+		m_nbytes = 0;
+	}
+
+	// the independent substream of the trial, such as a purpose of the draws of a field
+	void seed( unsigned long long seed, unsigned long long trial, unsigned long long stream )
+	{
+		unsigned long long x = seed ^ ( 0xD1B54A32D192ED03ull * ( trial + 1 ));
+
+		x = splitmix( x ) ^ ( 0xABC98388FB8FAC03ull * ( stream + 1 ));
+		for ( unsigned i = 0; i < 4; ++i ) m_s[ i ] = splitmix( x );
+		m_bytes  = 0;
+		m_nbytes = 0;
+	}
+
+	unsigned long long operator()()
+	{
+		unsigned long long r = rotl( m_s[ 1 ] * 5, 7 ) * 9;
+		unsigned long long t = m_s[ 1 ] << 17;
+
+		m_s[ 2 ] ^= m_s[ 0 ];
+		m_s[ 3 ] ^= m_s[ 1 ];
+		m_s[ 1 ] ^= m_s[ 2 ];
+		m_s[ 0 ] ^= m_s[ 3 ];
+		m_s[ 2 ] ^= t;
+		m_s[ 3 ] = rotl( m_s[ 3 ], 45 );
+
+		return r;
+	}
+
+	// 0 .. n-1, by the higher 32 bits
+	unsigned below( unsigned n ) { return ((( *this )() >> 32 ) * n ) >> 32; }
+	unsigned char byte()
+	{
+		if ( m_nbytes == 0 ) {
+			m_bytes  = ( *this )();
+			m_nbytes = 8;
+		}
+		--m_nbytes;
+		return m_bytes >> ( m_nbytes * 8 );
+	}
+};
+
+// seed for the case that --seed option is not specified
+inline unsigned long long random_seed()
+{
+	std::random_device	rd;
+
+	return ( static_cast<unsigned long long>( rd()) << 32 ) ^ rd() ^
+		 static_cast<unsigned long long>( std::time( nullptr ));
+}
+
 // flower gene, and hybrid operation
 // -----------------------------------------------------------------------------
 typedef unsigned char gene;		// Japanese local bit order: WW-YY-RR-SS (rose) / 00-WW-YY-RR (others)
 
-gene cross( gene x, gene y )
+// allele table: alleles of gene g selected by 4 bits n ( bit k of n selects the higher allele of
+// locus k ), which are placed on the lower bit of each locus.
+struct allele_table
+{
+	gene	t[ 256 ][ 16 ];
+
+	constexpr allele_table() : t()
+	{
+		for ( unsigned g = 0; g < 256; ++g ) {
+			for ( unsigned n = 0; n < 16; ++n ) {
+				unsigned a = 0;
+
+				for ( unsigned k = 0; k < 4; ++k )
+					a |= (((( n >> k ) & 1 ) ? ( g >> ( 2 * k + 1 )) : ( g >> ( 2 * k ))) & 1 ) << ( 2 * k );
+				t[ g ][ n ] = a;
+			}
+		}
+	}
+};
+
+constexpr allele_table	alleles;
+
+// hybrid by 8 random bits h, higher 4 bits for x, lower for y
+inline gene cross( gene x, gene y, unsigned h )
+{
+	return ( alleles.t[ x ][ ( h >> 4 ) & 15 ] << 1 ) | alleles.t[ y ][ h & 15 ];
+}
+
+inline gene cross( gene x, gene y, random_engine& e )
+{
+	return cross( x, y, e.byte());
+}
+
+// n ( <= 8 ) hybrids of the same parents by one random number
+inline void cross( gene x, gene y, gene* r, unsigned n, random_engine& e )
 {
-	unsigned	h = rand() % 256;		// higher 4 bits for x, lower for y
+	unsigned long long	h = e();
 
-	return (((( 0x80 & h ) ? 0x80 : 0x40 ) & x ) ? 0x80 : 0 ) |
-	       (((( 0x08 & h ) ? 0x80 : 0x40 ) & y ) ? 0x40 : 0 ) |
-	       (((( 0x40 & h ) ? 0x20 : 0x10 ) & x ) ? 0x20 : 0 ) |
-	       (((( 0x04 & h ) ? 0x20 : 0x10 ) & y ) ? 0x10 : 0 ) |
-	       (((( 0x20 & h ) ? 0x08 : 0x04 ) & x ) ? 0x08 : 0 ) |
-	       (((( 0x02 & h ) ? 0x08 : 0x04 ) & y ) ? 0x04 : 0 ) |
-	       (((( 0x10 & h ) ? 0x02 : 0x01 ) & x ) ? 0x02 : 0 ) |
-	       (((( 0x01 & h ) ? 0x02 : 0x01 ) & y ) ? 0x01 : 0 );
+	for ( unsigned i = 0; i < n && i < 8; ++i, h >>= 8 ) r[ i ] = cross( x, y, static_cast<unsigned>( h ));
 }
 
 // flower color
@@ -109,36 +234,40 @@ constexpr unsigned char growthChar( growth n )
 // -----------------------------------------------------------------------------
 class flower
 {
-    protected:
-	const flowerType	m_type;
-	const gene		m_gene;	
-	const flowerColor	m_color;	// Woops! Gold Rose is Rose(0000)!
-	watered			m_water;	// 0 .. 20
-	visitor			m_visitor;	// 0 .. 5
-	growth			m_growth;	// 0 .. 3 
-	const bool		m_clone;
-	bool			m_hydro;
-	bool			m_goldflag;
-	bool			m_partner;
-
-	// static members
-	static pctl::plist<flower*, pctl::pStore> m_pool;
+	// 4 byte value record, species behavior comes from the species table
+	// ( the default constructed flower is the empty cell of the flower field )
+
+	unsigned		m_type : 4;	// flowerType, Cv for empty
+	unsigned		m_gene : 8;
+	unsigned		m_color : 4;	// Woops! Gold Rose is Rose(0000)!
+	unsigned		m_water : 5;	// 0 .. 20
+	unsigned		m_visitor : 3;	// 0 .. 5
+	unsigned		m_growth : 2;	// 0 .. 3 
+	unsigned		m_clone : 1;
+	unsigned		m_hydro : 1;
+	unsigned		m_goldflag : 1;
+	unsigned		m_partner : 1;
 
+    public:
 	// constructor
-	flower( flowerType t, gene g, flowerColor c, growth growth, bool clone = false )
+	constexpr flower()
+		: m_type( Cv ), m_gene( 0 ), m_color( NA ), m_water( 0 ), m_visitor( 0 ),
+		  m_growth( 0 ), m_clone( false ),
+		  m_hydro( false ), m_goldflag( false ), m_partner( false ) { }
+	constexpr flower( flowerType t, gene g, flowerColor c, growth growth, bool clone = false )
 		: m_type( t ), m_gene( g ), m_color( c ), m_water( 0 ), m_visitor( 0 ),
 		  m_growth( growth ), m_clone( clone ),
 		  m_hydro( false ), m_goldflag( false ), m_partner( false ) { }
 
-    public:
-	virtual ~flower() { };
-	
+	explicit operator bool() const	{ return m_type != Cv; }
+
+	flowerType get_type() const	{ return static_cast<flowerType>( m_type ); }
 	gene get_gene() const		{ return m_gene; }
-	flowerColor get_color() const	{ return m_color; }
+	flowerColor get_color() const	{ return static_cast<flowerColor>( m_color ); }
 
-	virtual bool is_samekind( const flower* f ) const = 0;
-	virtual bool is_goldrose() const { return false; } 
-	virtual bool is_rollable_goldrose() const { return false; }
+	bool is_samekind( const flower* f ) const { return f && f->m_type == m_type; }
+	bool is_goldrose() const { return m_color == Gl; } 
+	bool is_rollable_goldrose() const { return m_type == Ro && m_color == Bk && m_goldflag; }
 
 	// user acitivities
 	void hydrate( visitor n = 0 )
@@ -161,25 +290,20 @@ class flower
 	void daily_reset()		{ m_hydro = false; m_visitor = 0; }
 
 	bool is_hydrate() const { return m_hydro; }
-	bool is_applicable() const
-	{
-		return ( is_partner() && is_growth( 3 ) && !is_goldrose() && 
-			 hybrid_ratio( m_water, m_visitor ) > ( rand() % 100 ));
-	}
+	bool is_applicable( random_engine& e ) const;
 
 	bool is_growth( growth n ) const { return m_growth == n; }
 	bool is_partner() const { return m_partner; }
 	bool is_color( flowerColor c ) const { return m_color == c; }
-	bool is_color( flower* f ) const { return m_color == f->m_color; }
+	bool is_color( const flower* f ) const { return m_color == f->m_color; }
 
-	virtual flower* hybrid( const flower* f = nullptr ) = 0;	// generate a flower and return the owner pointer
-	const bool is_clone() const { return m_clone; }
+	flower hybrid( const flower* f, random_engine& e ) const;	// generate a flower of the same species
+	bool is_clone() const { return m_clone; }
 
-	virtual void print( bool gn = false, bool cr = false, FILE* f = stderr );
-	virtual void print_gene( FILE* f = stderr );
+	void print( bool gn = false, bool cr = false, FILE* f = stderr ) const;
+	void print_gene( FILE* f = stderr ) const;
 
 	// static methonds
-	static void clear_pool() { m_pool.clear(); }
 	static constexpr const unsigned flower_no( const gene g )
 	{
 		return (( g >> 2 ) ? flower_no( g >> 2 ) * 3 : 0 ) +
@@ -187,15 +311,15 @@ class flower
 	}
 };
 
-pctl::plist<flower*, pctl::pStore> flower::m_pool;
+static_assert( sizeof( flower ) == 4, "flower must be a 4 byte record" );
 	
 // -----------------------------------------------------------------------------
-inline void flower::print( bool gn, bool cr, FILE* f )
+inline void flower::print( bool gn, bool cr, FILE* f ) const
 {
 	fprintf( f, "%c%c%c%s", is_partner() ? ' ' : '>',
-				flowerTypeChar( m_type ),
+				flowerTypeChar( get_type()),
 				growthChar( m_growth ),
-				colorString( m_color ));
+				colorString( get_color()));
 	if ( gn ) {
 		putc( '[', f );
 		print_gene( f );
@@ -205,9 +329,25 @@ inline void flower::print( bool gn, bool cr, FILE* f )
 }
 		
 // -----------------------------------------------------------------------------
-inline void flower::print_gene( FILE* f )
+inline void flower::print_gene( FILE* f ) const
 {
-	// excepting rose
+	if ( m_type == Ro ) {
+#ifdef __JLOCAL
+		fprintf( f, "%c%c%c%c", 
+			 (( 0xC0 & m_gene ) == 0xC0 ) ? '8' : (( 0xC0 & m_gene ) == 0 ) ? '.' : 'o',
+			 (( 0x30 & m_gene ) == 0x30 ) ? '8' : (( 0x30 & m_gene ) == 0 ) ? '.' : 'o',
+			 (( 0x0C & m_gene ) == 0x0C ) ? '8' : (( 0x0C & m_gene ) == 0 ) ? '.' : 'o',
+			 (( 0x03 & m_gene ) == 0x03 ) ? '*' : (( 0x03 & m_gene ) == 0 ) ? '.' : '+' );
+#else
+		// Global RYWS style: 0x34(b00110100) -> "1200"
+		fprintf( f, "%c%c%c%c", 
+			 (( 0x0C & m_gene ) == 0x0C ) ? '2' : (( 0x0C & m_gene ) == 0 ) ? '0' : '1',
+			 (( 0x30 & m_gene ) == 0x30 ) ? '2' : (( 0x30 & m_gene ) == 0 ) ? '0' : '1',
+			 (( 0xC0 & m_gene ) == 0xC0 ) ? '2' : (( 0xC0 & m_gene ) == 0 ) ? '0' : '1',
+			 (( 0x03 & m_gene ) == 0x03 ) ? '2' : (( 0x03 & m_gene ) == 0 ) ? '0' : '1' );
+#endif
+		return;
+	}
 
 #ifdef __JLOCAL
 	fprintf( f, " %c%c%c", 
@@ -232,8 +372,10 @@ const gene gPkRose = 0xCF;	// Mystery Island
 const gene gOrRose = 0x7D;	// Mystery Island
 const gene gGlRose = 0x00;
 
-class rose : public flower
+class rose
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
 	{
 		const flowerColor c[ 81 ] = {
@@ -250,60 +392,13 @@ class rose : public flower
 		return c[ n ];
 	};
 
-	rose( gene g, growth growth, bool clone, bool golden )
-		: flower( Ro, g, golden ? Gl : color( flower_no( g )), growth, clone ) { }
-
-    public:
-	~rose() { }
-
-	bool is_samekind( const flower* f ) const override
-	{
-		return dynamic_cast<const rose*>( f ) ? true : false;
-	}
-	bool is_goldrose() const override
-	{
-		return m_color == Gl;
-	}
-	bool is_rollable_goldrose() const override
-	{
-		return m_color == Bk && m_goldflag == true;
-	}
-	flower* hybrid( const flower* f = nullptr ) override
-	{
-		if ( is_samekind( f )) 
-			return rose::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return rose::create( m_gene, 2, true );
-	}
-	void print_gene( FILE* f = stdout ) override;
-
 	// static methods
-	static flower* create( gene g, unsigned growth = 0, bool clone = false, bool golden = false )
+	static flower create( gene g, unsigned growth = 0, bool clone = false, bool golden = false )
 	{
-		flower* r = new rose( g, growth, clone, golden );
-		m_pool.push_front( r );
-		return r;
+		return flower( Ro, g, golden ? Gl : color( flower::flower_no( g )), growth, clone );
 	}
 };
 
-inline void rose::print_gene( FILE* f )
-{
-#ifdef __JLOCAL
-	fprintf( f, "%c%c%c%c", 
-		 (( 0xC0 & m_gene ) == 0xC0 ) ? '8' : (( 0xC0 & m_gene ) == 0 ) ? '.' : 'o',
-		 (( 0x30 & m_gene ) == 0x30 ) ? '8' : (( 0x30 & m_gene ) == 0 ) ? '.' : 'o',
-		 (( 0x0C & m_gene ) == 0x0C ) ? '8' : (( 0x0C & m_gene ) == 0 ) ? '.' : 'o',
-		 (( 0x03 & m_gene ) == 0x03 ) ? '*' : (( 0x03 & m_gene ) == 0 ) ? '.' : '+' );
-#else
-	// Global RYWS style: 0x34(b00110100) -> "1200"
-	fprintf( f, "%c%c%c%c", 
-		 (( 0x0C & m_gene ) == 0x0C ) ? '2' : (( 0x0C & m_gene ) == 0 ) ? '0' : '1',
-		 (( 0x30 & m_gene ) == 0x30 ) ? '2' : (( 0x30 & m_gene ) == 0 ) ? '0' : '1',
-		 (( 0xC0 & m_gene ) == 0xC0 ) ? '2' : (( 0xC0 & m_gene ) == 0 ) ? '0' : '1',
-		 (( 0x03 & m_gene ) == 0x03 ) ? '2' : (( 0x03 & m_gene ) == 0 ) ? '0' : '1' );
-#endif
-}
-
 // Hyacinth
 // -----------------------------------------------------------------------------
 const gene gWhHyacinth = 0x10;		// Shop
@@ -313,8 +408,10 @@ const gene gPkHyacinth = 0x11;		// Island
 const gene gOrHyacinth = 0x0D;		// Island
 const gene gBuHyacinth = 0x07;		// Island
 
-class hyacinth : public flower
+class hyacinth
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -325,30 +422,11 @@ class hyacinth : public flower
                 return c[ n ];
 	};
 
-	hyacinth( gene g, growth growth, bool clone ) : flower( Hy, g, color( flower_no( g )), growth, clone ) { }
-
-    public:
-	~hyacinth() { }
-
-        bool is_samekind( const flower* f ) const override
-        {       
-                return dynamic_cast<const hyacinth*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {       
-		if ( is_samekind( f )) 
-			return hyacinth::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return hyacinth::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new hyacinth( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( Hy, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Lily
@@ -359,8 +437,10 @@ const gene gRdLily = 0x13;		// Shop
 const gene gPkLily = 0x37;		// Island
 const gene gOrLily = 0x1F;		// Island
 
-class lily : public flower
+class lily
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -371,30 +451,11 @@ class lily : public flower
                 return c[ n ];
 	};
 
-        lily( gene g, growth growth, bool clone ) : flower( Li, g, color( flower_no( g )), growth, clone ) { }
-        
-    public:
-        ~lily() { }
-        
-        bool is_samekind( const flower* f ) const override
-        {
-                return dynamic_cast<const lily*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {
-		if ( is_samekind( f )) 
-			return lily::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return lily::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new lily( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( Li, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Anemone
@@ -405,8 +466,10 @@ const gene gRdAnemone = 0x03;		// Shop
 const gene gPkAnemone = 0x1F;		// Island
 const gene gBuAnemone = 0x31;		// Island
 
-class anemone : public flower
+class anemone
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -417,30 +480,11 @@ class anemone : public flower
                 return c[ n ];
 	};
 
-        anemone( gene g, growth growth, bool clone ) : flower( An, g, color( flower_no( g )), growth, clone ) { }
-        
-    public:
-        ~anemone() { }
-        
-        bool is_samekind( const flower* f ) const override
-        {
-                return dynamic_cast<const anemone*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {
-		if ( is_samekind( f )) 
-			return anemone::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return anemone::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new anemone( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( An, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Pansie
@@ -451,8 +495,10 @@ const gene gRdPansie = 0x03;		// Shop
 const gene gBuPansie = 0x31;		// Island
 const gene gYRPansie = 0x1F;		// Island
 
-class pansie : public flower
+class pansie
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -463,30 +509,11 @@ class pansie : public flower
                 return c[ n ];
 	};
 
-        pansie( gene g, growth growth, bool clone ) : flower( Pa, g, color( flower_no( g )), growth, clone ) { }
-        
-    public:
-        ~pansie() { }
-        
-        bool is_samekind( const flower* f ) const override
-        {
-                return dynamic_cast<const pansie*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {
-		if ( is_samekind( f )) 
-			return pansie::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return pansie::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new pansie( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( Pa, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Cosmos
@@ -497,8 +524,10 @@ const gene gRdCosmos = 0x03;		// Shop
 const gene gPkCosmos = 0x35;		// Island
 const gene gOrCosmos = 0x17;		// Island
 
-class cosmos : public flower
+class cosmos
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -509,30 +538,11 @@ class cosmos : public flower
                 return c[ n ];
 	};
 
-        cosmos( gene g, growth growth, bool clone ) : flower( Co, g, color( flower_no( g )), growth, clone ) { }
-        
-    public:
-        ~cosmos() { }
-        
-        bool is_samekind( const flower* f ) const override
-        {
-                return dynamic_cast<const cosmos*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {
-		if ( is_samekind( f )) 
-			return cosmos::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return cosmos::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new cosmos( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( Co, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Chrysanthemum
@@ -543,8 +553,10 @@ const gene gRdMum = 0x03;		// Shop
 const gene gPuMum = 0x17;		// Island
 const gene gPkMum = 0x35;		// Island
 
-class mum : public flower
+class mum
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -555,30 +567,11 @@ class mum : public flower
                 return c[ n ];
 	};
 
-        mum( gene g, growth growth, bool clone ) : flower( Ch, g, color( flower_no( g )), growth, clone ) { }
-        
-    public:
-        ~mum() { }
-        
-        bool is_samekind( const flower* f ) const override
-        {
-                return dynamic_cast<const mum*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {
-		if ( is_samekind( f )) 
-			return mum::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return mum::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new mum( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( Ch, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Tulip
@@ -590,8 +583,10 @@ const gene gPkTulip = 0x11;		// Island
 const gene gOrTulip = 0x0D;		// Island
 const gene gBkTulip = 0x07;		// Island
 
-class tulip : public flower
+class tulip
 {
+    public:
+	// color table by flower::flower_no()
 	static constexpr flowerColor color( unsigned n )
         {
                 const flowerColor c[ 27 ] = {
@@ -602,59 +597,189 @@ class tulip : public flower
                 return c[ n ];
 	};
 
-        tulip( gene g, growth growth, bool clone ) : flower( Tu, g, color( flower_no( g )), growth, clone ) { }
-        
-    public:
-        ~tulip() { }
-        
-        bool is_samekind( const flower* f ) const override
-        {
-                return dynamic_cast<const tulip*>( f ) ? true : false;
-        }
-        flower* hybrid( const flower* f = nullptr ) override
-        {
-		if ( is_samekind( f )) 
-			return tulip::create( cross( m_gene, f->get_gene()), 2 );
-		else
-			return tulip::create( m_gene, 2, true );
-        }
-        
-        // static methods
-        static flower* create( gene g, unsigned growth = 0, bool clone = false )
-        {       
-                flower* r = new tulip( g, growth, clone );
-                m_pool.push_front( r );
-                return r;
-        }
+	// static methods
+	static flower create( gene g, unsigned growth = 0, bool clone = false )
+	{
+		return flower( Tu, g, color( flower::flower_no( g )), growth, clone );
+	}
 };
 
 // Wild Lily
 // -----------------------------------------------------------------------------
-class wildlily : public flower
+class wildlily
+{
+    public:
+	// static methods
+	static flower create() { return flower( WL, 0, Wh, 3 ); }
+};
+
+// species table
+// -----------------------------------------------------------------------------
+constexpr flowerColor species_color( flowerType t, unsigned n )
+{
+	// color of flower::flower_no() n of the species t
+	return ( t == Ro ) ? rose::color( n ) :
+	       ( n >= 27 ) ? NA :
+	       ( t == Hy ) ? hyacinth::color( n ) :
+	       ( t == Li ) ? lily::color( n ) :
+	       ( t == An ) ? anemone::color( n ) :
+	       ( t == Pa ) ? pansie::color( n ) :
+	       ( t == Co ) ? cosmos::color( n ) :
+	       ( t == Ch ) ? mum::color( n ) :
+	       ( t == Tu ) ? tulip::color( n ) :
+	       ( t == WL ) ? Wh : NA;
+}
+
+struct species_table
+{
+	// color by flower::flower_no(), and the number of gene pairs ( 0: never hybrid )
+	flowerColor		color[ WL + 1 ][ 81 ];
+	unsigned char		genes[ WL + 1 ];
+
+	constexpr species_table() : color(), genes()
+	{
+		for ( unsigned t = Cv; t <= WL; ++t ) {
+			for ( unsigned n = 0; n < 81; ++n ) color[ t ][ n ] = species_color( static_cast<flowerType>( t ), n );
+			genes[ t ] = ( t == Ro ) ? 4 : ( t == Cv || t == WL ) ? 0 : 3;
+		}
+	}
+};
+
+constexpr species_table species;
+
+// -----------------------------------------------------------------------------
+inline bool flower::is_applicable( random_engine& e ) const
+{
+	return ( species.genes[ m_type ] && is_partner() && is_growth( 3 ) && !is_goldrose() && 
+		 hybrid_ratio( m_water, m_visitor ) > e.below( 100 ));
+}
+
+// -----------------------------------------------------------------------------
+inline flower flower::hybrid( const flower* f, random_engine& e ) const
+{
+	// crossed with the same kind partner, or cloned
+	if ( is_samekind( f )) {
+		gene	g = cross( m_gene, f->m_gene, e );
+
+		return flower( get_type(), g, species.color[ m_type ][ flower_no( g ) ], 2 );
+	} else {
+		return flower( get_type(), m_gene, species.color[ m_type ][ flower_no( m_gene ) ], 2, true );
+	}
+}
+
+// exact offspring distribution
+// -----------------------------------------------------------------------------
+constexpr gene genotype_gene( unsigned n )
+{
+	// representative gene of flower::flower_no() n, heterozygote as 01
+	return ( n == 0 ) ? 0 : ( genotype_gene( n / 3 ) << 2 ) | (( n % 3 == 2 ) ? 3 : n % 3 );
+}
+
+const unsigned Genotypes = 81;		// rose: 3^4, the others use 27 of them
+
+struct offspring_distribution
+{
+	// counts in 256 allele choices of the hybrid
+	unsigned short		genotype[ Genotypes ];		// by flower::flower_no()
+	unsigned short		color[ 12 ];			// by flowerColor
+
+	double p( flowerColor c ) const { return color[ c ] / 256.0; }
+	double p_gene( gene g ) const { return genotype[ flower::flower_no( g ) ] / 256.0; }
+
+	void print( FILE* f = stdout ) const;
+};
+
+inline void offspring_distribution::print( FILE* f ) const
 {
-	wildlily() : flower( WL, 0, Wh, 3 ) { }
+	for ( unsigned c = 1; c < 12; ++c ) {
+		if ( color[ c ] ) fprintf( f, " %s:%.2f%%", colorString( static_cast<flowerColor>( c )), 100.0 * color[ c ] / 256 );
+	}
+	putc( '\n', f );
+}
+
+class offspring_table
+{
+	// exact offspring distributions of all pairs of genotypes, in cumulative counts
+	// ( m_cdf[ x ][ y ][ n ] = number of allele choices making genotype <= n )
+
+	unsigned short		m_cdf[ Genotypes ][ Genotypes ][ Genotypes ];
+	unsigned short		m_color[ WL + 1 ][ Genotypes ][ Genotypes ][ 12 ];
+
+	offspring_table()
+	{
+		for ( unsigned x = 0; x < Genotypes; ++x ) {
+			for ( unsigned y = 0; y < Genotypes; ++y ) {
+				unsigned short	n[ Genotypes ] = { 0 };
+
+				for ( unsigned h = 0; h < 256; ++h )
+					++n[ flower::flower_no( cross( genotype_gene( x ), genotype_gene( y ), h )) ];
+
+				unsigned short	s = 0;
+
+				for ( unsigned k = 0; k < Genotypes; ++k ) m_cdf[ x ][ y ][ k ] = ( s += n[ k ] );
+
+				for ( unsigned t = Cv; t <= WL; ++t ) {
+					unsigned short* c = m_color[ t ][ x ][ y ];
+
+					for ( unsigned i = 0; i < 12; ++i ) c[ i ] = 0;
+					for ( unsigned k = 0; k < Genotypes; ++k ) {
+						if ( n[ k ] ) c[ species.color[ t ][ k ] ] += n[ k ];
+					}
+				}
+			}
+		}
+	}
 
     public:
-	~wildlily() { }
+	// built on the first use ( about 2.6MB )
+	static const offspring_table& instance()
+	{
+		static const offspring_table* const	t = new offspring_table();
 
-        bool is_samekind( const flower* f ) const override
-        {       
-                return dynamic_cast<const wildlily*>( f ) ? true : false;
-        }
-	flower* hybrid( const flower* f = nullptr ) override
+		return *t;
+	}
+
+	offspring_distribution operator()( flowerType t, gene x, gene y ) const
+	{
+		offspring_distribution		r;
+		const unsigned short*		cdf = m_cdf[ flower::flower_no( x ) ][ flower::flower_no( y ) ];
+		const unsigned short*		col = m_color[ t ][ flower::flower_no( x ) ][ flower::flower_no( y ) ];
+
+		for ( unsigned k = 0; k < Genotypes; ++k ) r.genotype[ k ] = cdf[ k ] - ( k ? cdf[ k - 1 ] : 0 );
+		for ( unsigned i = 0; i < 12; ++i ) r.color[ i ] = col[ i ];
+
+		return r;
+	}
+
+	// probability of the color c in the hybrids of x and y
+	double probability( flowerType t, gene x, gene y, flowerColor c ) const
 	{
-		return nullptr;
+		return m_color[ t ][ flower::flower_no( x ) ][ flower::flower_no( y ) ][ c ] / 256.0;
 	}
 
-        // static methods
-        static flower* create()
-        {       
-                flower* r = new wildlily();
-                m_pool.push_front( r );
-                return r;
-        }
+	// offspring by the random byte u ( 0..255 ), by the same distribution of cross()
+	gene sample( gene x, gene y, unsigned u ) const
+	{
+		const unsigned short*	cdf = m_cdf[ flower::flower_no( x ) ][ flower::flower_no( y ) ];
+		unsigned		lo = 0;
+		unsigned		hi = Genotypes - 1;
+
+		while ( lo < hi ) {
+			unsigned m = ( lo + hi ) / 2;
+
+			if ( u < cdf[ m ] ) hi = m; else lo = m + 1;
+		}
+		return genotype_gene( lo );
+	}
+	gene sample( gene x, gene y, random_engine& e ) const { return sample( x, y, e.byte()); }
 };
 
+// exact offspring distribution of x x y, by the enumeration of all 256 allele choices
+inline offspring_distribution offspring( flowerType t, gene x, gene y )
+{
+	return offspring_table::instance()( t, x, y );
+}
+
 // flower_field
 // -----------------------------------------------------------------------------
 template <unsigned C>
@@ -682,31 +807,450 @@ struct coord
 	void print( FILE* f = stderr ) const { fprintf( f, "{%u,%u}", r, c ); }
 };
 
+// bit set of the cells of a flower field
 // -----------------------------------------------------------------------------
-template <unsigned R, unsigned C> class planting_plan;
-template <unsigned R, unsigned C> class harvesting_plan;
-
-// -----------------------------------------------------------------------------
-class ff_base
+template <unsigned N>
+struct bitboard
 {
-	// virtual base class for flower_field<R,C>
+	static const unsigned	Words = ( N + 63 ) / 64;
 
-    protected:
-	std::string	m_name;
-	unsigned 	m_fstep;
+	uint64_t		w[ Words ];
 
-	static bool	m_verbose;
+	bitboard() { clear(); }
 
-    public:
-	ff_base( const char* n ) : m_name( n ), m_fstep( 0 ) { }
-	virtual ~ff_base() { }
+	void clear() { for ( unsigned i = 0; i < Words; ++i ) w[ i ] = 0; }
+	void set( unsigned b ) { w[ b / 64 ] |= uint64_t( 1 ) << ( b % 64 ); }
+	void reset( unsigned b ) { w[ b / 64 ] &= ~( uint64_t( 1 ) << ( b % 64 )); }
+	bool test( unsigned b ) const { return ( w[ b / 64 ] >> ( b % 64 )) & 1; }
 
-	// re-initialize the field for new simulation steps
-	virtual void recycle() { m_fstep = 0; }
+	bitboard operator&( const bitboard& x ) const
+	{
+		bitboard r;
+		for ( unsigned i = 0; i < Words; ++i ) r.w[ i ] = w[ i ] & x.w[ i ];
+		return r;
+	}
+	bitboard and_not( const bitboard& x ) const
+	{
+		bitboard r;
+		for ( unsigned i = 0; i < Words; ++i ) r.w[ i ] = w[ i ] & ~x.w[ i ];
+		return r;
+	}
 
-	// plant queue I/F
-	virtual bool put( flower* f ) = 0;
-	virtual bool is_open() const = 0;
+	unsigned count() const
+	{
+		unsigned n = 0;
+		for ( unsigned i = 0; i < Words; ++i ) n += __builtin_popcountll( w[ i ] );
+		return n;
+	}
+	unsigned select( unsigned k ) const
+	{
+		// position of the k-th ( 0 origin ) set bit, k < count()
+		for ( unsigned i = 0; i < Words; ++i ) {
+			unsigned	n = __builtin_popcountll( w[ i ] );
+			uint64_t	x = w[ i ];
+
+			if ( k < n ) {
+				while ( k-- ) x &= x - 1;
+				return i * 64 + __builtin_ctzll( x );
+			}
+			k -= n;
+		}
+		return N;
+	}
+};
+
+// Snapshot
+//	byte image of the state of a running trial, which is restored into an instance of the same
+//	simulator class ( clone()). the structure made by the constructors is not included.
+// -----------------------------------------------------------------------------
+class snapshot
+{
+	std::vector<unsigned char>	m_data;
+	size_t				m_pos;		// read position
+
+    public:
+	snapshot() : m_pos( 0 ) { }
+
+	template <typename T>
+	void put( const T& v )
+	{
+		static_assert( std::is_trivially_copyable<T>::value, "snapshot of non trivially copyable type" );
+
+		const unsigned char*	p = reinterpret_cast<const unsigned char*>( &v );
+
+		m_data.insert( m_data.end(), p, p + sizeof( T ));
+	}
+	template <typename T>
+	void get( T& v )
+	{
+		static_assert( std::is_trivially_copyable<T>::value, "snapshot of non trivially copyable type" );
+
+		assert( m_pos + sizeof( T ) <= m_data.size());
+		memcpy( &v, &m_data[ m_pos ], sizeof( T ));
+		m_pos += sizeof( T );
+	}
+
+	void clear() { m_data.clear(); m_pos = 0; }
+	void rewind() { m_pos = 0; }
+	size_t size() const { return m_data.size(); }
+	bool is_consumed() const { return m_pos == m_data.size(); }
+};
+
+// Trace policy
+//	ACNH_TRACE=0 compiles the events of the fields out, for the regression builds.
+//	by default the fields send the events to the sink bound by the simulator.
+// -----------------------------------------------------------------------------
+#ifndef ACNH_TRACE
+#define ACNH_TRACE	1
+#endif
+
+struct trace_off { static constexpr bool enabled = false; };
+struct trace_on  { static constexpr bool enabled = true;  };
+
+#if ACNH_TRACE
+typedef trace_on	trace_policy;
+#else
+typedef trace_off	trace_policy;
+#endif
+
+// Hot-path counters
+//	ACNH_COUNTERS=1 counts the stages of the daily refresh and the plant queues of every
+//	field, reported at the end of simulate() and regression(). field_counters_off is empty.
+// -----------------------------------------------------------------------------
+#ifndef ACNH_COUNTERS
+#define ACNH_COUNTERS	0
+#endif
+
+struct counter_kind
+{
+	enum { Hydrated, Applicable, Cross, Clone, NoSpace, Candidates, GoldRoll, Overflow, Counters };
+
+	static const char* name( unsigned k )
+	{
+		static const char* const	names[ Counters ] = {
+			"hydrated", "applicable", "cross", "clone", "no space", "candidates", "gold roll", "overflow" };
+
+		return ( k < Counters ) ? names[ k ] : "?";
+	}
+};
+
+struct field_counters_on : public counter_kind
+{
+	static constexpr bool	enabled = true;
+
+	unsigned long long	n[ Counters ];
+
+	field_counters_on() : n() { }
+
+	void add( unsigned k, unsigned long long v = 1 ) { n[ k ] += v; }
+	unsigned long long get( unsigned k ) const { return n[ k ]; }
+	void merge( const field_counters_on& o ) { for ( unsigned k = 0; k < Counters; ++k ) n[ k ] += o.n[ k ]; }
+};
+
+struct field_counters_off : public counter_kind
+{
+	static constexpr bool	enabled = false;
+
+	void add( unsigned, unsigned long long = 1 ) { }
+	unsigned long long get( unsigned ) const { return 0; }
+	void merge( const field_counters_off& ) { }
+};
+
+#if ACNH_COUNTERS
+typedef field_counters_on	field_counters;
+#else
+typedef field_counters_off	field_counters;
+#endif
+
+// Event trace
+//	trace_event::print() renders the text of the verbose mode, then the verbose output
+//	( trace_text ) and a binary trace ( trace_file ) of the same trial are the same text.
+//
+//	file:	"ACNHTRC1", seed ( u64 ), trial ( u32 ), number of fields ( u32 ),
+//		field names ( 32 bytes each ), then the events ( 24 bytes each )
+// -----------------------------------------------------------------------------
+struct trace_event
+{
+	enum : uint8_t { Cross, Clone, GoldRoll, Plant, Harvest, Unused, Full, Kinds };
+
+	static const uint8_t	None = 0xff;		// no partner, no destination field
+	static const uint8_t	WithGene = 0x01;	// flags: print the gene of the harvest
+	static const uint8_t	Isolated = 0x02;	// flags: Full of ff_isolated
+
+	uint8_t		kind;
+	uint8_t		field;		// index of the field in the simulator
+	uint16_t	day;		// steps of the field
+	uint8_t		r[ 3 ];		// the flower, the partner and the child
+	uint8_t		c[ 3 ];
+	uint8_t		aux;		// GoldRoll: 1 for a gold rose bud, Harvest: destination field or None,
+					// Unused: queued flowers
+	uint8_t		flags;
+	flower		fl[ 3 ];
+
+	trace_event( uint8_t k = Cross ) : kind( k ), field( None ), day( 0 ), r(), c(), aux( None ), flags( 0 ), fl() { }
+
+	template <unsigned C>
+	void set( unsigned i, const flower& f, const coord<C>& pos ) { fl[ i ] = f; r[ i ] = pos.r; c[ i ] = pos.c; }
+
+	// the text of the verbose mode, or the other events with all
+	void print( const char* name, const char* dest, bool all, FILE* fp = stderr ) const
+	{
+		switch ( kind ) {
+			case Cross:
+			case Clone:
+				fprintf( fp, "*** %c:", name[ 0 ] );
+				fl[ 0 ].print( true, false, fp );
+				fprintf( fp, "{%u,%u}", r[ 0 ], c[ 0 ] );
+				if ( kind == Cross ) {
+					fprintf( fp, " x " );
+					fl[ 1 ].print( true, false, fp );
+					fprintf( fp, "{%u,%u}", r[ 1 ], c[ 1 ] );
+				}
+				fprintf( fp, " => " );
+				fl[ 2 ].print( true, false, fp );
+				fprintf( fp, "{%u,%u}\n", r[ 2 ], c[ 2 ] );
+				break;
+			case Harvest:
+				if ( aux == None ) {
+					fprintf( fp, "Info: harvest from %s, scrap ", name );
+					fl[ 0 ].print( flags & WithGene, true, fp );
+				} else if ( all ) {
+					fprintf( fp, "--- %u %s: harvest ", day, name );
+					fl[ 0 ].print( true, false, fp );
+					fprintf( fp, "{%u,%u} -> %s\n", r[ 0 ], c[ 0 ], dest );
+				}
+				break;
+			case Plant:
+				if ( all ) {
+					fprintf( fp, "--- %u %s: plant ", day, name );
+					fl[ 0 ].print( true, false, fp );
+					fprintf( fp, "{%u,%u}\n", r[ 0 ], c[ 0 ] );
+				}
+				break;
+			case GoldRoll:
+				if ( all ) fprintf( fp, "--- %u %s: gold rose roll {%u,%u} %s\n", day, name, r[ 0 ], c[ 0 ], aux ? "hit" : "miss" );
+				break;
+			case Unused:
+				fprintf( fp, "Warning: queued %u flowers unused\n", aux );
+				break;
+			case Full:
+				fprintf( fp, "Warning: %s(%s) is full\n", ( flags & Isolated ) ? "ff_isolated" : "ff_storage", name );
+				break;
+		}
+	}
+	static const char* kind_name( unsigned k )
+	{
+		static const char* const	names[ Kinds ] = { "cross", "clone", "gold roll", "plant", "harvest", "unused", "full" };
+
+		return ( k < Kinds ) ? names[ k ] : "?";
+	}
+};
+
+// Trace sinks
+//	the fields send the events to a sink, the simulator binds trace_text for --verbose,
+//	trace_file for --trace file and trace_tee for the both.
+// -----------------------------------------------------------------------------
+class trace_sink
+{
+    public:
+	virtual ~trace_sink() { }
+	virtual void put( const char* name, const trace_event& e ) = 0;
+};
+
+class trace_text : public trace_sink
+{
+	FILE*	m_fp;
+	bool	m_all;
+
+    public:
+	trace_text( FILE* fp = stderr, bool all = false ) : m_fp( fp ), m_all( all ) { }
+
+	void put( const char* name, const trace_event& e ) override { e.print( name, "", m_all, m_fp ); }
+};
+
+class trace_count : public trace_sink
+{
+	std::vector<std::string>	m_names;	// [ field ]
+	std::vector<unsigned long long>	m_count;	// [ field * Kinds + kind ]
+
+    public:
+	void put( const char* name, const trace_event& e ) override
+	{
+		unsigned	f = ( e.field == trace_event::None ) ? 0 : e.field;
+
+		if ( m_names.size() <= f ) {
+			m_names.resize( f + 1 );
+			m_count.resize(( f + 1 ) * trace_event::Kinds );
+		}
+		m_names[ f ] = name;
+		++m_count[ f * trace_event::Kinds + e.kind ];
+	}
+	void print( FILE* fp = stdout ) const
+	{
+		fprintf( fp, "%-24s", "field" );
+		for ( unsigned k = 0; k < trace_event::Kinds; ++k ) fprintf( fp, " %10s", trace_event::kind_name( k ));
+		fprintf( fp, "\n" );
+		for ( unsigned f = 0; f < m_names.size(); ++f ) {
+			if ( m_names[ f ].empty()) continue;
+			fprintf( fp, "%-24s", m_names[ f ].c_str());
+			for ( unsigned k = 0; k < trace_event::Kinds; ++k ) fprintf( fp, " %10llu", m_count[ f * trace_event::Kinds + k ] );
+			fprintf( fp, "\n" );
+		}
+	}
+};
+
+class trace_tee : public trace_sink
+{
+	std::vector<trace_sink*>	m_sinks;
+
+    public:
+	void clear() { m_sinks.clear(); }
+	void add( trace_sink* p ) { if ( p ) m_sinks.push_back( p ); }
+	bool empty() const { return m_sinks.empty(); }
+	trace_sink* sink() { return ( m_sinks.size() == 1 ) ? m_sinks.front() : ( empty() ? nullptr : this ); }
+
+	void put( const char* name, const trace_event& e ) override { for ( trace_sink* p : m_sinks ) p->put( name, e ); }
+};
+
+class trace_file : public trace_sink
+{
+	FILE*				m_fp;
+	std::vector<trace_event>	m_buf;		// written by BufferEvents
+	std::vector<std::string>	m_names;
+	unsigned long long		m_seed;
+	unsigned			m_trial;
+
+	static const unsigned		BufferEvents = 4096;
+	static const unsigned		NameLength = 32;
+
+    public:
+	trace_file() : m_fp( nullptr ), m_seed( 0 ), m_trial( 0 ) { }
+	~trace_file() { close(); }
+
+	bool create( const char* path, unsigned long long seed, unsigned trial, const std::vector<std::string>& names )
+	{
+		uint64_t	sd = seed;
+		uint32_t	h[ 2 ] = { trial, (uint32_t) names.size() };
+		char		nm[ NameLength ];
+
+		if ( !( m_fp = fopen( path, "wb" ))) {
+			fprintf( stderr, "Error: cannot create %s\n", path );
+			return false;
+		}
+		fwrite( "ACNHTRC1", 1, 8, m_fp );
+		fwrite( &sd, sizeof( sd ), 1, m_fp );
+		fwrite( h, sizeof( h ), 1, m_fp );
+		for ( const std::string& n : names ) {
+			strncpy( nm, n.c_str(), NameLength );
+			nm[ NameLength - 1 ] = '\0';
+			fwrite( nm, 1, NameLength, m_fp );
+		}
+		m_buf.reserve( BufferEvents );
+
+		return true;
+	}
+	bool open( const char* path )
+	{
+		char		magic[ 8 ];
+		uint64_t	sd;
+		uint32_t	h[ 2 ];
+		char		nm[ NameLength ];
+
+		if (( m_fp = fopen( path, "rb" )) &&
+		    fread( magic, 1, 8, m_fp ) == 8 && memcmp( magic, "ACNHTRC1", 8 ) == 0 &&
+		    fread( &sd, sizeof( sd ), 1, m_fp ) == 1 && fread( h, sizeof( h ), 1, m_fp ) == 1 ) {
+			m_seed  = sd;
+			m_trial = h[ 0 ];
+			for ( unsigned i = 0; i < h[ 1 ]; ++i ) {
+				if ( fread( nm, 1, NameLength, m_fp ) != NameLength ) break;
+				m_names.push_back( std::string( nm, strnlen( nm, NameLength )));
+			}
+			if ( m_names.size() == h[ 1 ] ) return true;
+		}
+		fprintf( stderr, "Error: %s is not a trace file\n", path );
+		close();
+
+		return false;
+	}
+	void close()
+	{
+		if ( m_fp ) {
+			flush();
+			fclose( m_fp );
+		}
+		m_fp = nullptr;
+	}
+
+	void put( const char*, const trace_event& e ) override
+	{
+		m_buf.push_back( e );
+		if ( m_buf.size() == BufferEvents ) flush();
+	}
+	void flush()
+	{
+		if ( m_fp && !m_buf.empty()) fwrite( m_buf.data(), sizeof( trace_event ), m_buf.size(), m_fp );
+		m_buf.clear();
+	}
+	bool get( trace_event& e ) { return m_fp && fread( &e, sizeof( e ), 1, m_fp ) == 1; }
+
+	unsigned long long seed() const { return m_seed; }
+	unsigned trial() const { return m_trial; }
+	const char* name( unsigned i ) const { return ( i < m_names.size()) ? m_names[ i ].c_str() : "?"; }
+};
+
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C> class planting_plan;
+template <unsigned R, unsigned C> class harvesting_plan;
+
+// random streams of a field, one for each purpose of the draws
+//	the simulator seeds them by ( seed, trial, field id ), then the fields of the same id in two
+//	methods draw the same process orders, rolls, spaces, partners and crosses while they breed alike.
+// -----------------------------------------------------------------------------
+struct field_streams
+{
+	enum purpose { Order, Roll, Space, Partner, Cross, Purposes };
+
+	random_engine	e[ Purposes ];
+
+	void seed( unsigned long long seed, unsigned long long trial, unsigned id )
+	{
+		for ( unsigned k = 0; k < Purposes; ++k ) e[ k ].seed( seed, trial, ( static_cast<unsigned long long>( id ) << 8 ) | k );
+	}
+};
+
+// -----------------------------------------------------------------------------
+class ff_base
+{
+	// virtual base class for flower_field<R,C>
+
+    protected:
+	std::string	m_name;
+	unsigned 	m_fstep;
+	random_engine*	m_rng[ field_streams::Purposes ];	// bound by the simulator which owns the field
+	trace_sink*	m_sink;		// events of the field, nullptr if not traced
+	uint8_t		m_id;		// index of the field in the simulator for the trace
+	field_counters	m_counters;	// through all the trials
+
+	static thread_local bool	m_verbose;
+	static thread_local bool	m_bitboard;	// neighborhood queries by bitboards or by scan
+
+    public:
+	ff_base( const char* n ) : m_name( n ), m_fstep( 0 ), m_rng(), m_sink( nullptr ), m_id( trace_event::None ) { }
+	virtual ~ff_base() { }
+
+	// one engine for all the draws, or the streams of the field
+	void bind( random_engine* e ) { for ( random_engine*& r : m_rng ) r = e; }
+	void bind( field_streams* s ) { for ( unsigned k = 0; k < field_streams::Purposes; ++k ) m_rng[ k ] = &s->e[ k ]; }
+	random_engine& rng( field_streams::purpose p ) const { return *m_rng[ p ]; }
+	void bind( trace_sink* t, unsigned id ) { m_sink = t; m_id = id; }
+	uint8_t id() const { return m_id; }
+
+	// re-initialize the field for new simulation steps
+	virtual void recycle() { m_fstep = 0; }
+
+	// plant queue I/F
+	virtual bool put( const flower& f ) = 0;
+	virtual bool is_open() const = 0;
 
 	// simulation steps
 	virtual void harvest() = 0;
@@ -718,21 +1262,128 @@ class ff_base
 	virtual unsigned count() const = 0;
 	virtual unsigned count( flowerColor c ) const = 0;
 	//virtual const unsigned field_units() const = 0;
-	virtual const flower* const* begin() const = 0;
-	virtual const flower* const* end() const = 0;
-	virtual const flower* const* begin( unsigned r ) const = 0;
-	virtual const flower* const* end( unsigned r ) const = 0;
+	virtual const flower* begin() const = 0;
+	virtual const flower* end() const = 0;
+	virtual const flower* begin( unsigned r ) const = 0;
+	virtual const flower* end( unsigned r ) const = 0;
+
+	// snapshot I/F, derived fields with their own state override them and call the base
+	virtual void save_state( snapshot& s ) const { s.put( m_fstep ); }
+	virtual void load_state( snapshot& s ) { s.get( m_fstep ); }
 
 	// misc.
 	const char* name() const { return m_name.c_str(); }
+	unsigned stream_id() const;
 	unsigned steps() const { return m_fstep; }
+
+	// hot-path counters, nothing is left by field_counters_off
+	void tally( unsigned k, unsigned long long v = 1 ) { m_counters.add( k, v ); }
+	const field_counters& counters() const { return m_counters; }
+	void merge_counters( const ff_base& o ) { m_counters.merge( o.m_counters ); }
+
+	// an event of this field to the sink, nothing is left by trace_off
+	bool is_traced() const { return trace_policy::enabled && m_sink; }
+	void trace( trace_event e ) const
+	{
+		if ( !is_traced()) return;
+		e.field = m_id;
+		e.day   = m_fstep;
+		m_sink->put( name(), e );
+	}
 	virtual void print( bool w_gene = false ) const = 0;
 
 	// static member functions
 	static void verbose( bool v ) { m_verbose = v; }
+	static bool is_verbose() { return m_verbose; }
+	static void bitboard( bool b ) { m_bitboard = b; }
+	static bool is_bitboard() { return m_bitboard; }
+
+    protected:
+	// a flower of the daily_refresh() loop, shared by flower_field<R,C> and ff_dynamic.
+	//	Cell is the cell of the field ( coord<C> or the index ), Near is the lookup of the field:
+	//	  flower& at( Cell )						the flower in the cell
+	//	  void grown( const flower*, Cell )				after grow()
+	//	  Cell* space( Cell ), Cell* partner( const flower*, Cell )	planting space and partner
+	//	  void locate( trace_event&, unsigned, const flower&, Cell )	position of a trace event
+	//	  void bred( const flower&, Cell space, Cell f, const Cell* p )	puts the hybrid
+	template <typename Cell, typename Near>
+	void breed( Near& n, const Cell& cf );
 };
 
-bool ff_base::m_verbose = false;
+thread_local bool ff_base::m_verbose = false;
+thread_local bool ff_base::m_bitboard = true;
+
+// id of the random streams, by the stage label of the name ( "7" of "7: Pu4 x Or5 -> Or7", as the
+// field id of the pipeline files ), or by the whole name without the label ( FNV-1a )
+inline unsigned ff_base::stream_id() const
+{
+	size_t		n = m_name.find( ':' );
+	unsigned	h = 2166136261u;
+
+	for ( char c : m_name.substr( 0, n )) h = ( h ^ static_cast<unsigned char>( c )) * 16777619u;
+	return h;
+}
+
+// -----------------------------------------------------------------------------
+template <typename Cell, typename Near>
+void ff_base::breed( Near& n, const Cell& cf )
+{
+	flower*		f = &n.at( cf );
+
+	f->grow();
+	n.grown( f, cf );
+	if ( f->is_hydrate()) {
+		tally( counter_kind::Hydrated );
+		f->increment_water();
+		if ( f->is_applicable( rng( field_streams::Roll ))) {
+			tally( counter_kind::Applicable );
+			if ( auto ps = n.space( cf )) {
+				auto		pc = n.partner( f, cf );
+				flower*		p = pc ? &n.at( *pc ) : nullptr;
+				flower		hy;
+				trace_event	e( p ? trace_event::Cross : trace_event::Clone );
+
+				if ( is_traced()) {
+					n.locate( e, 0, *f, cf );
+					if ( p ) n.locate( e, 1, *p, *pc );
+				}
+				if ( f->is_rollable_goldrose() || ( p && p->is_rollable_goldrose())) {
+					bool	gold = rng( field_streams::Cross ).below( 100 ) < 50;
+
+					tally( counter_kind::GoldRoll );
+					if ( is_traced()) {
+						trace_event	g( trace_event::GoldRoll );
+
+						n.locate( g, 0, *f, cf );
+						g.aux = gold;
+						trace( g );
+					}
+					if ( gold ) {
+						hy = rose::create( gGlRose, 2, false, true );	// Gold Rose Bud
+						f->reset_after_goldrose();
+						if ( p ) p->reset_after_goldrose();
+					} else {
+						hy = f->hybrid( p, rng( field_streams::Cross ));
+					}
+				} else {
+					hy = f->hybrid( p, rng( field_streams::Cross ));
+				}
+				if ( is_traced()) {
+					n.locate( e, 2, hy, *ps );
+					trace( e );
+				}
+				tally( p ? counter_kind::Cross : counter_kind::Clone );
+
+				n.bred( hy, *ps, cf, pc );
+				f->reset_after_hybrid();
+				if ( p ) p->reset_after_hybrid();
+			} else {
+				tally( counter_kind::NoSpace );
+			}
+		}
+	}
+	f->daily_reset();
+}
 
 template <unsigned R, unsigned C>
 class flower_field : public ff_base
@@ -748,7 +1399,7 @@ class flower_field : public ff_base
 
 		flower_field<R,C>*	m_owner;
 		coord<C>		m_order[ R * C ];
-		flower*			m_queue[ R * C ];
+		flower			m_queue[ R * C ];
 		unsigned 		m_size;
 		unsigned 		m_cur;
 		unsigned 		m_pos;
@@ -775,12 +1426,13 @@ class flower_field : public ff_base
 		bool is_open() const { return m_cur < m_size; }
 		void close() { clean(); m_pos = m_cur = m_size; }
 
-		bool put( flower* f )
+		bool put( const flower& f )
 		{
 			if ( m_cur < m_size ) {
 				m_queue[ m_cur++ ] = f;
 				return true;
 			} else {
+				m_owner->tally( counter_kind::Overflow );
 				return false;
 			}
 		}
@@ -789,26 +1441,37 @@ class flower_field : public ff_base
 			unsigned	n = m_cur - m_pos;
 	
 			while ( m_pos < m_cur ) {
-				m_owner->get( m_order[ m_pos ] ) = m_queue[ m_pos ];
+				m_owner->cell( m_order[ m_pos ] ) = m_queue[ m_pos ];
+				if ( m_owner->is_traced()) {
+					trace_event	e( trace_event::Plant );
+
+					e.set( 0, m_queue[ m_pos ], m_order[ m_pos ] );
+					m_owner->trace( e );
+				}
 				++m_pos;
 			}
 			return n;
 		}
-		flower* pick()
+		flower pick()
 		{
-			flower*		r = nullptr;
+			flower		r;
 
 			if ( 0 < m_pos ) {
-				flower*& f = m_owner->get( m_order[ --m_pos ] );	// don't use queued old flower
+				flower& f = m_owner->cell( m_order[ --m_pos ] );	// don't use queued old flower
 				r = f; 
-				f = nullptr;
+				f = flower();
 			}
 			return r;
 		}
 		void clean()
 		{
 			if ( m_pos < m_cur ) {
-				if ( m_verbose ) fprintf( stderr, "Warning: queued %u flowers unused\n", m_cur - m_pos );
+				if ( m_owner->is_traced()) {
+					trace_event	e( trace_event::Unused );
+
+					e.aux = m_cur - m_pos;
+					m_owner->trace( e );
+				}
 				m_pos = m_cur;
 			}
 		}
@@ -816,6 +1479,20 @@ class flower_field : public ff_base
 		unsigned size() const { return m_size; }
 		unsigned count() const { return m_cur; }
 
+		// snapshot, m_order is defined by the owner's constructor
+		void save_state( snapshot& s ) const
+		{
+			s.put( m_queue );
+			s.put( m_cur );
+			s.put( m_pos );
+		}
+		void load_state( snapshot& s )
+		{
+			s.get( m_queue );
+			s.get( m_cur );
+			s.get( m_pos );
+		}
+
 		// iterator ---------------------------------------------------
 		typedef const coord<C>* const_iterator;
 	
@@ -862,34 +1539,24 @@ class flower_field : public ff_base
 
 	class random_list
 	{
+		// daily process order: occupied cells are put in, then shuffled
+		// by Fisher-Yates in O(n), every order has the same probability.
+
 		coord<C>	m_list[ R * C ];
-		int		m_keys[ R * C ];
 		unsigned	m_pos;
 
 	    public:
 		random_list() : m_pos( 0 ) { }
 
-		void put( int k, const coord<C>& c )
+		void put( const coord<C>& c ) { if ( m_pos < R * C ) m_list[ m_pos++ ] = c; }
+		void shuffle( random_engine& e )
 		{
-			if ( m_pos < R * C ) {
-				bool	s = false;
+			for ( unsigned i = m_pos; 1 < i; --i ) {
+				unsigned j = e.below( i );
+				coord<C> t = m_list[ i - 1 ];
 
-				for ( unsigned i = m_pos; 0 < i; --i ) {
-					if ( k < m_keys[ i - 1 ] ) {
-						m_keys[ i ] = m_keys[ i - 1 ];
-						m_list[ i ] = m_list[ i - 1 ];
-					} else {
-						m_keys[ i ] = k;
-						m_list[ i ] = c;
-						s = true;
-						break;
-					}
-				}
-				if ( !s ) {
-					m_keys[ 0 ] = k;
-					m_list[ 0 ] = c;
-				}
-				++m_pos;
+				m_list[ i - 1 ] = m_list[ j ];
+				m_list[ j ] = t;
 			}
 		}
 		void clear() { m_pos = 0; }
@@ -904,18 +1571,68 @@ class flower_field : public ff_base
 		const_iterator	end() const { return &m_list[ m_pos ]; }
 	};
 
-	typedef pctl::plist<coord<C>>		 hybrid_list;
+	class hybrid_list
+	{
+		// positions of the flowers generated today, in the order of generation.
+		// each of them takes an empty cell, so R * C entries are enough and
+		// no allocation is made; clear() just rewinds.
+
+		coord<C>	m_list[ R * C ];
+		unsigned	m_pos;
+
+	    public:
+		hybrid_list() : m_pos( 0 ) { }
+
+		void push_back( const coord<C>& c ) { if ( m_pos < R * C ) m_list[ m_pos++ ] = c; }
+		void clear() { m_pos = 0; }
+		unsigned size() const { return m_pos; }
+		bool empty() const { return m_pos == 0; }
+
+		// iterator ---------------------------------------------------
+		typedef coord<C>* 	iterator;
+		typedef const coord<C>*	const_iterator;
+
+		iterator	begin() { return &m_list[ 0 ]; }
+		const_iterator	begin() const { return &m_list[ 0 ]; }
+		iterator	end() { return &m_list[ m_pos ]; }
+		const_iterator	end() const { return &m_list[ m_pos ]; }
+	};
+
+	struct around_table
+	{
+		// 8-neighborhood of each cell by index, in the order of the former 3x3 scan
+		// ( column outer, row inner ), clipped by the field edges
+
+		unsigned short	ix[ R * C ][ 8 ];
+		unsigned char	n[ R * C ];
+
+		constexpr around_table() : ix(), n()
+		{
+			for ( unsigned i = 0; i < R * C; ++i ) {
+				unsigned	r = i / C;
+				unsigned	c = i % C;
+
+				for ( unsigned cc = ( 0 < c ) ? c - 1 : 0; cc < C && cc <= c + 1; ++cc ) {
+					for ( unsigned rr = ( 0 < r ) ? r - 1 : 0; rr < R && rr <= r + 1; ++rr ) {
+						if ( rr != r || cc != c ) ix[ i ][ n[ i ]++ ] = rr * C + cc;
+					}
+				}
+			}
+		}
+	};
+
+	static constexpr around_table	m_around = around_table();	// per instantiation
 
 	// member variables
-	flower*		m_field[ R * C ];
+	flower		m_field[ R * C ];	// by value, empty cell is flower()
 	bool		m_cover[ R * C ];
 	hybrid_list	m_generation;
 
     public:
-	flower_field( const char* n ) : ff_base( n )
+	flower_field( const char* n ) : ff_base( n ), m_near_valid( false )
 	{
 		for ( unsigned i = 0; i < R * C; ++i ) {
-			m_field[ i ] = nullptr;
+			m_field[ i ] = flower();
 			m_cover[ i ] = false;
 		}
 	}
@@ -924,15 +1641,32 @@ class flower_field : public ff_base
 	void recycle() override
 	{
 		for ( unsigned i = 0; i < R * C; ++i ) {
-			m_field[ i ] = nullptr;
+			m_field[ i ] = flower();
 			m_cover[ i ] = false;
 		}
+		m_near_valid = false;
 		m_generation.clear();				// for fail safe
 		ff_base::recycle();
 	}
 
+	void save_state( snapshot& s ) const override
+	{
+		ff_base::save_state( s );
+		s.put( m_field );
+		s.put( m_cover );
+		s.put( m_generation );
+	}
+	void load_state( snapshot& s ) override
+	{
+		ff_base::load_state( s );
+		s.get( m_field );
+		s.get( m_cover );
+		s.get( m_generation );
+		m_near_valid = false;
+	}
+
 	// plant queue I/F
-	bool put( flower* f ) override { return false; }	
+	bool put( const flower& f ) override { return false; }	
 	bool is_open() const override { return false; }
  
 	// simulation steps - defaults
@@ -942,29 +1676,30 @@ class flower_field : public ff_base
 	void daily_refresh() final;	// increment m_fstep here
 
 	// flower field I/F
-	flower* get( const coord<C>& pos ) const { return m_field[ pos.index() ]; }
-	// flower*& get( const coord<C>& pos ) is protected
-	const flower* get( unsigned ix ) const { return m_field[ ix ]; }
-	void set( flower* f, const coord<C>& pos )
+	// get() returns the pointer to the flower in the cell, or nullptr if the cell is empty
+	flower* get( const coord<C>& pos ) { return cell( pos ) ? &cell( pos ) : nullptr; }
+	const flower* get( const coord<C>& pos ) const { return m_field[ pos.index() ] ? &m_field[ pos.index() ] : nullptr; }
+	const flower* get( unsigned ix ) const { return m_field[ ix ] ? &m_field[ ix ] : nullptr; }
+	void set( const flower& f, const coord<C>& pos )
 	{
 		if ( pos.c < C && pos.r < R && !covered( pos ))
 		m_field[ pos.index() ] = f;
 	}
-	flower* pull( const coord<C>& pos );
-	void cover( const coord<C>& pos ) { m_cover[ pos.index() ] = true; }
+	flower pull( const coord<C>& pos );	// return flower() if the cell is empty
+	void cover( const coord<C>& pos ) { m_cover[ pos.index() ] = true; m_near_valid = false; }
 	bool covered( const coord<C>& pos ) const { return m_cover[ pos.index() ]; }
 	void hydrate( visitor n, const coord<C>& pos ) { if ( flower* p = get( pos )) p->hydrate( n ); }
 
 	unsigned count() const override;
 	unsigned count( flowerColor c ) const override;
 	constexpr const unsigned field_units() const { return ( R / 6 + 1 ) * ( C / 4 + 1 ); }
-	const flower* const* begin() const override { return &m_field[ 0 ]; }			// iterator
-	const flower* const* end() const override { return &m_field[ R * C ]; }
-	const flower* const* begin( unsigned r ) const override					// row iterator
+	const flower* begin() const override { return &m_field[ 0 ]; }			// iterator
+	const flower* end() const override { return &m_field[ R * C ]; }
+	const flower* begin( unsigned r ) const override					// row iterator
 	{
 		return ( r < R ) ? &m_field[ r * C ] : nullptr;
 	}
-	const flower* const* end( unsigned r ) const override
+	const flower* end( unsigned r ) const override
 	{
 		return ( r < R ) ? &m_field[ r * C + C ] : nullptr;
 	}
@@ -973,95 +1708,118 @@ class flower_field : public ff_base
 	void print( bool w_gene = false ) const override;
 
     protected:
-	flower*& get( const coord<C>& pos ) { return m_field[ pos.index() ]; }
-	coord<C>* planting_space( coord<C> c );	// return ptr to elem of m_around, or nullptr if no planting space
-	coord<C>* search_for_partner( flower* p, coord<C> c );
-};
+	flower& cell( const coord<C>& pos ) { return m_field[ pos.index() ]; }
+	coord<C>* planting_space( coord<C> c );	// return ptr to elem of m_space, or nullptr if no planting space
+	coord<C>* search_for_partner( const flower* p, coord<C> c );
 
-// member of flower_field<R,C>
-// -----------------------------------------------------------------------------
-template <unsigned R, unsigned C>
-void flower_field<R,C>::hydrate( visitor n )
-{
-	for ( unsigned i = 0; i < R * C; ++i ) {
-		if ( flower* fp = m_field[ i ] ) fp->hydrate( n );
-	}
-}
+	// bitboard versions, the bit of a cell is column-major for the same candidate order as the scan
+	typedef ::bitboard<R * C>	board;
 
-// -----------------------------------------------------------------------------
-template <unsigned R, unsigned C>
-void flower_field<R,C>::daily_refresh()
-{
-	m_generation.clear();
+	static constexpr unsigned bit( const coord<C>& c ) { return c.c * R + c.r; }
+	static coord<C> bit_coord( unsigned b ) { return { b % R, b / R }; }
 
-	random_list	shuffle;
+	coord<C>* planting_space( coord<C> c, const board& occupied );
+	coord<C>* search_for_partner( const board& mates, coord<C> c );
 
-	// shuffle process order
+	// lookup of breed(), by the bitboards of today or by the scan
+	struct near_cells
+	{
+		flower_field<R,C>&	ff;
+		const bool		bb;
+		board			occupied;
+		board			ready;			// is_growth( 3 ) && is_partner()
+		board			kind[ WL + 1 ];		// by flowerType
+
+		near_cells( flower_field<R,C>& f, bool b ) : ff( f ), bb( b ) { }
+
+		flower& at( const coord<C>& c ) { return ff.cell( c ); }
+		void grown( const flower* f, const coord<C>& c )
+		{
+			if ( f->is_growth( 3 ) && f->is_partner()) ready.set( bit( c ));
+		}
+		coord<C>* space( const coord<C>& c ) { return bb ? ff.planting_space( c, occupied ) : ff.planting_space( c ); }
+		coord<C>* partner( const flower* f, const coord<C>& c )
+		{
+			return bb ? ff.search_for_partner( ready & kind[ f->get_type() ], c ) : ff.search_for_partner( f, c );
+		}
+		void locate( trace_event& e, unsigned i, const flower& f, const coord<C>& c ) const { e.set( i, f, c ); }
+		void bred( const flower& hy, const coord<C>& ps, const coord<C>& cf, const coord<C>* pc )
+		{
+			ff.set( hy, ps );
+			ff.m_generation.push_back( ps );
+			occupied.set( bit( ps ));
+			kind[ hy.get_type() ].set( bit( ps ));
+			ready.reset( bit( cf ));
+			if ( pc ) ready.reset( bit( *pc ));
+		}
+	};
+
+    private:
+	void make_near();
+
+	unsigned short	m_near[ R * C ][ 8 ];	// m_around without covered cells, made by make_near()
+	unsigned char	m_nnear[ R * C ];
+	board		m_nearb[ R * C ];	// m_near as bitboards
+	bool		m_near_valid;		// reset by cover() and recycle()
+
+	coord<C>	m_space[ 8 ];		// work area of planting_space()
+	coord<C>	m_mates[ 8 ];		// work area of search_for_partner()
+};
+
+template <unsigned R, unsigned C>
+constexpr typename flower_field<R,C>::around_table flower_field<R,C>::m_around;
+
+// member of flower_field<R,C>
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C>
+void flower_field<R,C>::hydrate( visitor n )
+{
+	for ( unsigned i = 0; i < R * C; ++i ) {
+		if ( m_field[ i ] ) m_field[ i ].hydrate( n );
+	}
+}
+
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C>
+void flower_field<R,C>::daily_refresh()
+{
+	m_generation.clear();
+
+	assert( m_rng[ 0 ] );
+
+	random_list	shuffle;
+	near_cells	near( *this, m_bitboard );
+
+	if ( !m_near_valid ) make_near();
+
+	// shuffle process order
 	for ( unsigned r = 0; r < R; ++r ) {
 		for ( unsigned c = 0; c < C; ++c ) {
 			flower* fp = get( { r, c } );
 			if ( fp != nullptr ) {
 				fp->daily_init();
-				shuffle.put( std::rand(), { r, c } );
+				shuffle.put( { r, c } );
+
+				near.occupied.set( bit( { r, c } ));
+				near.kind[ fp->get_type() ].set( bit( { r, c } ));
+				if ( fp->is_growth( 3 )) near.ready.set( bit( { r, c } ));
 			}
 		}
 	}
+	shuffle.shuffle( rng( field_streams::Order ));
 
 	// loop
-	for ( coord<C> cf : shuffle ) {
-		flower* f = get( cf );
-
-		f->grow();
-		if ( f->is_hydrate()) {
-			f->increment_water();
-			if ( f->is_applicable()) {
-				if ( coord<C>* ps = planting_space( cf )) {
-					coord<C>* pc = search_for_partner( f, cf );
-					flower*   p = pc ? get( *pc ) : nullptr;
-					flower*   hy;
-					if (( f->is_rollable_goldrose() || ( p && p->is_rollable_goldrose())) &&
-					      std::rand() % 100 < 50 ) {
-						hy = rose::create( gGlRose, 2, false, true );	// Gold Rose Bud
-						f->reset_after_goldrose();
-						if ( p ) p->reset_after_goldrose();
-					} else {
-						hy = f->hybrid( p );
-					}
-
-					if ( m_verbose ) {
-						fprintf( stderr, "*** %c:", this->name()[ 0 ]);
-						f->print( true );
-						cf.print();
-						if ( p ) {
-							fprintf( stderr, " x " );
-							p->print( true );
-							pc->print();
-						}
-						fprintf( stderr, " => " );
-						hy->print( true );
-						ps->print();
-					}
-
-					set( hy, *ps );
-					m_generation.push_back( *ps );
-
-					f->reset_after_hybrid();
-					if ( p ) p->reset_after_hybrid();
-				}
-			}
-		}
-		f->daily_reset();
-	}
+	for ( coord<C> cf : shuffle ) breed( near, cf );
 	++m_fstep;
 }
 
 // -----------------------------------------------------------------------------
 template <unsigned R, unsigned C>
-flower* flower_field<R,C>::pull( const coord<C>& pos )
+flower flower_field<R,C>::pull( const coord<C>& pos )
 {
-	flower*	r = get( pos );
+	flower	r = cell( pos );
 
-	if ( r ) set( nullptr, pos );
+	if ( r ) set( flower(), pos );
 
 	return r;
 }
@@ -1073,7 +1831,7 @@ unsigned flower_field<R,C>::count() const
 	unsigned n = 0;
 
 	for ( unsigned i = 0; i < R * C; ++i )
-		if ( m_field[ i ] != nullptr ) ++n;
+		if ( m_field[ i ] ) ++n;
 
 	return n;
 }
@@ -1085,55 +1843,90 @@ unsigned flower_field<R,C>::count( flowerColor c ) const
 	unsigned n = 0;
 
 	for ( unsigned i = 0; i < R * C; ++i )
-		if ( m_field[ i ] && m_field[ i ]->get_color() == c ) ++n;
+		if ( m_field[ i ] && m_field[ i ].get_color() == c ) ++n;
 
 	return n;
 }
 
 // -----------------------------------------------------------------------------
 template <unsigned R, unsigned C>
-coord<C>* flower_field<R,C>::planting_space( coord<C> cf )
+void flower_field<R,C>::make_near()
 {
-	static coord<C>	around[ 8 ];
+	for ( unsigned i = 0; i < R * C; ++i ) {
+		unsigned	n = 0;
 
-	unsigned	n = 0;
-	unsigned char	cb = ( 0 < cf.c ) ? cf.c - 1 : 0;
-	unsigned char	rb = ( 0 < cf.r ) ? cf.r - 1 : 0;
-	unsigned char	ce = ( cf.c + 1 < C ) ? cf.c + 2 : C;
-	unsigned char	re = ( cf.r + 1 < R ) ? cf.r + 2 : R;
+		m_nearb[ i ].clear();
+		for ( unsigned k = 0; k < m_around.n[ i ]; ++k ) {
+			unsigned	j = m_around.ix[ i ][ k ];
 
-	for ( unsigned char c = cb; c < ce; ++c ) {
-		for ( unsigned char r = rb; r < re; ++r ) {
-			if ( !covered( { r, c } ) && !( c == cf.c && r == cf.r ) && get( { r, c } ) == nullptr )
-				around[ n++ ] = { r, c };
+			if ( !m_cover[ j ] ) {
+				m_near[ i ][ n++ ] = j;
+				m_nearb[ i ].set( bit( { j / C, j % C } ));
+			}
 		}
+		m_nnear[ i ] = n;
 	}
-	return ( 0 < n ) ? &around[ rand() % n ] : nullptr;
+	m_near_valid = true;
 }
 
 // -----------------------------------------------------------------------------
 template <unsigned R, unsigned C>
-coord<C>* flower_field<R,C>::search_for_partner( flower* p, coord<C> cf )
-{
-	static coord<C>	around[ 8 ];
-
-	unsigned char	cb = ( 0 < cf.c ) ? cf.c - 1 : 0;
-	unsigned char	rb = ( 0 < cf.r ) ? cf.r - 1 : 0;
-	unsigned char	ce = ( cf.c + 1 < C ) ? cf.c + 2 : C;
-	unsigned char	re = ( cf.r + 1 < R ) ? cf.r + 2 : R;
-	unsigned	n = 0;
-
-	for ( unsigned char c = cb; c < ce; ++c ) {
-		for ( unsigned char r = rb; r < re; ++r ) {
-			if ( !covered( { r, c } ) && !( c == cf.c && r == cf.r )) {
-				if ( flower* f = get( { r, c } )) {
-					if ( f->is_growth( 3 ) && f->is_samekind( p ) && f->is_partner())
-						around[ n++ ] = { r, c };
-				}
-			}
-		}
+coord<C>* flower_field<R,C>::planting_space( coord<C> cf )
+{
+	const unsigned short*	p = m_near[ cf.index() ];
+	const unsigned short*	e = p + m_nnear[ cf.index() ];
+	unsigned		n = 0;
+
+	for ( ; p < e; ++p ) {
+		if ( !m_field[ *p ] ) m_space[ n++ ] = { *p / C, *p % C };
+	}
+	return ( 0 < n ) ? &m_space[ rng( field_streams::Space ).below( n ) ] : nullptr;
+}
+
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C>
+coord<C>* flower_field<R,C>::search_for_partner( const flower* p, coord<C> cf )
+{
+	const unsigned short*	q = m_near[ cf.index() ];
+	const unsigned short*	e = q + m_nnear[ cf.index() ];
+	unsigned		n = 0;
+
+	for ( ; q < e; ++q ) {
+		const flower&	f = m_field[ *q ];
+
+		if ( f.is_growth( 3 ) && f.is_samekind( p ) && f.is_partner())
+			m_mates[ n++ ] = { *q / C, *q % C };
 	}
-	return ( n == 0 ) ? nullptr : ( n == 1 ) ? &around[ 0 ] : &around[ rand() % n ];
+	tally( counter_kind::Candidates, n );
+
+	return ( n == 0 ) ? nullptr : ( n == 1 ) ? &m_mates[ 0 ] : &m_mates[ rng( field_streams::Partner ).below( n ) ];
+}
+
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C>
+coord<C>* flower_field<R,C>::planting_space( coord<C> cf, const board& occupied )
+{
+	board		b = m_nearb[ cf.index() ].and_not( occupied );
+	unsigned	n = b.count();
+
+	if ( n == 0 ) return nullptr;
+
+	m_space[ 0 ] = bit_coord( b.select( rng( field_streams::Space ).below( n )));
+	return &m_space[ 0 ];
+}
+
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C>
+coord<C>* flower_field<R,C>::search_for_partner( const board& mates, coord<C> cf )
+{
+	board		b = m_nearb[ cf.index() ] & mates;
+	unsigned	n = b.count();
+
+	tally( counter_kind::Candidates, n );
+	if ( n == 0 ) return nullptr;
+
+	m_mates[ 0 ] = bit_coord( b.select(( n == 1 ) ? 0 : rng( field_streams::Partner ).below( n )));
+	return &m_mates[ 0 ];
 }
 
 // -----------------------------------------------------------------------------
@@ -1144,7 +1937,7 @@ void flower_field<R,C>::print( bool w_gene ) const
 	for ( unsigned char r = 0; r < R; ++r ) {
 		for ( unsigned char c = 0; c < C; ++c ) {
 			//putc( ' ', stderr );
-			if ( flower* p = get( { r, c } )) 
+			if ( const flower* p = get( { r, c } )) 
 				p->print( false );
 			else if ( covered( { r, c } ))
 				fprintf( stderr, " xxxx" );
@@ -1155,7 +1948,304 @@ void flower_field<R,C>::print( bool w_gene ) const
 		if ( w_gene ) {
 			for ( unsigned char c = 0; c < C; ++c ) {
 				putc( ' ', stderr );
-				if ( flower* p = get( { r, c } )) 
+				if ( const flower* p = get( { r, c } )) 
+					p->print_gene();
+				else
+					fprintf( stderr, "    " );
+			}
+			putc( '\n', stderr );
+		}
+	}
+}
+
+//
+// Runtime-sized Flower Field
+// -----------------------------------------------------------------------------
+
+// ff_dynamic
+//	flower_field<R,C> whose rows and columns are given at run time, for the layouts which
+//	are not compiled in. the cells are contiguous by rows, and daily_refresh() is the per-cell
+//	scan of flower_field<R,C> by the same ff_base::breed() with the same random draws in the
+//	same order, then a field of the same size and flowers makes the same hybrids. flower_field<R,C> stays the fast path
+//	( bitboards and fixed size tables ) of the sample simulators.
+// -----------------------------------------------------------------------------
+class ff_dynamic : public ff_base
+{
+    protected:
+	const unsigned		m_rows;
+	const unsigned		m_cols;
+
+	std::vector<flower>	m_field;	// [ r * cols + c ], empty cell is flower()
+	std::vector<uint8_t>	m_cover;
+	std::vector<unsigned>	m_generation;	// cells of the hybrids of today
+
+    public:
+	ff_dynamic( const char* n, unsigned rows, unsigned cols )
+		: ff_base( n ), m_rows( rows ), m_cols( cols ),
+		  m_field( rows * cols ), m_cover( rows * cols, 0 ),
+		  m_near( rows * cols * 8 ), m_nnear( rows * cols ), m_near_valid( false )
+	{
+		// coordinates of the trace events are uint8_t
+		assert( 0 < rows && rows <= 255 && 0 < cols && cols <= 255 );
+
+		m_generation.reserve( rows * cols );
+		m_order.reserve( rows * cols );
+	}
+	~ff_dynamic() { }
+
+	void recycle() override
+	{
+		std::fill( m_field.begin(), m_field.end(), flower());
+		std::fill( m_cover.begin(), m_cover.end(), 0 );
+		m_near_valid = false;
+		m_generation.clear();				// for fail safe
+		ff_base::recycle();
+	}
+
+	void save_state( snapshot& s ) const override
+	{
+		ff_base::save_state( s );
+		for ( const flower& f : m_field ) s.put( f );
+		for ( uint8_t c : m_cover ) s.put( c );
+		s.put( (unsigned) m_generation.size());
+		for ( unsigned i : m_generation ) s.put( i );
+	}
+	void load_state( snapshot& s ) override
+	{
+		unsigned	n;
+
+		ff_base::load_state( s );
+		for ( flower& f : m_field ) s.get( f );
+		for ( uint8_t& c : m_cover ) s.get( c );
+		s.get( n );
+		m_generation.resize( n );
+		for ( unsigned& i : m_generation ) s.get( i );
+		m_near_valid = false;
+	}
+
+	// plant queue I/F
+	bool put( const flower& f ) override { return false; }
+	bool is_open() const override { return false; }
+
+	// simulation steps - defaults
+	void harvest() override { }
+	void plant() override { }
+	void hydrate( visitor n = 0 ) override;
+	void daily_refresh() final;	// increment m_fstep here
+
+	// flower field I/F, a cell is by ( r, c ) or by its index r * cols() + c
+	unsigned rows() const { return m_rows; }
+	unsigned cols() const { return m_cols; }
+	unsigned index( unsigned r, unsigned c ) const { return r * m_cols + c; }
+
+	flower* get( unsigned ix ) { return m_field[ ix ] ? &m_field[ ix ] : nullptr; }
+	const flower* get( unsigned ix ) const { return m_field[ ix ] ? &m_field[ ix ] : nullptr; }
+	void set( const flower& f, unsigned r, unsigned c )
+	{
+		if ( r < m_rows && c < m_cols && !covered( r, c ))
+		m_field[ index( r, c ) ] = f;
+	}
+	flower pull( unsigned ix );	// return flower() if the cell is empty
+	void cover( unsigned r, unsigned c ) { m_cover[ index( r, c ) ] = true; m_near_valid = false; }
+	bool covered( unsigned r, unsigned c ) const { return m_cover[ index( r, c ) ]; }
+	void hydrate( visitor n, unsigned r, unsigned c ) { if ( flower* p = get( index( r, c ))) p->hydrate( n ); }
+
+	unsigned count() const override;
+	unsigned count( flowerColor c ) const override;
+	unsigned field_units() const { return ( m_rows / 6 + 1 ) * ( m_cols / 4 + 1 ); }
+	const flower* begin() const override { return m_field.data(); }			// iterator
+	const flower* end() const override { return m_field.data() + m_field.size(); }
+	const flower* begin( unsigned r ) const override					// row iterator
+	{
+		return ( r < m_rows ) ? &m_field[ r * m_cols ] : nullptr;
+	}
+	const flower* end( unsigned r ) const override
+	{
+		return ( r < m_rows ) ? &m_field[ r * m_cols ] + m_cols : nullptr;
+	}
+
+	// for debug and test
+	void print( bool w_gene = false ) const override;
+
+    protected:
+	const unsigned* planting_space( unsigned ix );	// return ptr to elem of m_space, or nullptr if no planting space
+	const unsigned* search_for_partner( const flower* p, unsigned ix );
+
+	// lookup of breed() by the scan
+	struct near_cells
+	{
+		ff_dynamic&	ff;
+
+		flower& at( unsigned ix ) { return ff.m_field[ ix ]; }
+		void grown( const flower*, unsigned ) { }
+		const unsigned* space( unsigned ix ) { return ff.planting_space( ix ); }
+		const unsigned* partner( const flower* f, unsigned ix ) { return ff.search_for_partner( f, ix ); }
+		void locate( trace_event& e, unsigned i, const flower& f, unsigned ix ) const
+		{
+			e.fl[ i ] = f;
+			e.r[ i ]  = ix / ff.m_cols;
+			e.c[ i ]  = ix % ff.m_cols;
+		}
+		void bred( const flower& hy, unsigned ps, unsigned, const unsigned* )
+		{
+			ff.m_field[ ps ] = hy;
+			ff.m_generation.push_back( ps );
+		}
+	};
+
+    private:
+	void make_near();
+
+	std::vector<unsigned short>	m_near;		// [ ix * 8 + k ], not covered neighbors by make_near()
+	std::vector<unsigned char>	m_nnear;
+	bool				m_near_valid;	// reset by cover() and recycle()
+
+	std::vector<unsigned>		m_order;	// work area of daily_refresh(), process order
+	unsigned			m_space[ 8 ];	// work area of planting_space()
+	unsigned			m_mates[ 8 ];	// work area of search_for_partner()
+};
+
+// member of ff_dynamic
+// -----------------------------------------------------------------------------
+void ff_dynamic::hydrate( visitor n )
+{
+	for ( flower& f : m_field ) {
+		if ( f ) f.hydrate( n );
+	}
+}
+
+// -----------------------------------------------------------------------------
+void ff_dynamic::daily_refresh()
+{
+	m_generation.clear();
+
+	assert( m_rng[ 0 ] );
+
+	random_engine&	order = rng( field_streams::Order );
+
+	if ( !m_near_valid ) make_near();
+
+	// shuffle process order, Fisher-Yates as random_list of flower_field<R,C>
+	m_order.clear();
+	for ( unsigned i = 0; i < m_field.size(); ++i ) {
+		if ( m_field[ i ] ) {
+			m_field[ i ].daily_init();
+			m_order.push_back( i );
+		}
+	}
+	for ( unsigned i = m_order.size(); 1 < i; --i ) {
+		unsigned j = order.below( i );
+
+		std::swap( m_order[ i - 1 ], m_order[ j ] );
+	}
+
+	// loop
+	near_cells	near = { *this };
+
+	for ( unsigned cf : m_order ) breed( near, cf );
+	++m_fstep;
+}
+
+// -----------------------------------------------------------------------------
+flower ff_dynamic::pull( unsigned ix )
+{
+	flower	r = m_field[ ix ];
+
+	if ( r && !m_cover[ ix ] ) m_field[ ix ] = flower();
+
+	return r;
+}
+
+// -----------------------------------------------------------------------------
+unsigned ff_dynamic::count() const
+{
+	unsigned n = 0;
+
+	for ( const flower& f : m_field )
+		if ( f ) ++n;
+
+	return n;
+}
+
+// -----------------------------------------------------------------------------
+unsigned ff_dynamic::count( flowerColor c ) const
+{
+	unsigned n = 0;
+
+	for ( const flower& f : m_field )
+		if ( f && f.get_color() == c ) ++n;
+
+	return n;
+}
+
+// -----------------------------------------------------------------------------
+void ff_dynamic::make_near()
+{
+	// the order of the 3x3 scan ( column outer, row inner ) as around_table of flower_field<R,C>
+	for ( unsigned i = 0; i < m_field.size(); ++i ) {
+		unsigned	r = i / m_cols;
+		unsigned	c = i % m_cols;
+		unsigned	n = 0;
+
+		for ( unsigned cc = ( 0 < c ) ? c - 1 : 0; cc < m_cols && cc <= c + 1; ++cc ) {
+			for ( unsigned rr = ( 0 < r ) ? r - 1 : 0; rr < m_rows && rr <= r + 1; ++rr ) {
+				if (( rr != r || cc != c ) && !m_cover[ index( rr, cc ) ] ) m_near[ i * 8 + n++ ] = index( rr, cc );
+			}
+		}
+		m_nnear[ i ] = n;
+	}
+	m_near_valid = true;
+}
+
+// -----------------------------------------------------------------------------
+const unsigned* ff_dynamic::planting_space( unsigned cf )
+{
+	const unsigned short*	p = &m_near[ cf * 8 ];
+	const unsigned short*	e = p + m_nnear[ cf ];
+	unsigned		n = 0;
+
+	for ( ; p < e; ++p ) {
+		if ( !m_field[ *p ] ) m_space[ n++ ] = *p;
+	}
+	return ( 0 < n ) ? &m_space[ rng( field_streams::Space ).below( n ) ] : nullptr;
+}
+
+// -----------------------------------------------------------------------------
+const unsigned* ff_dynamic::search_for_partner( const flower* p, unsigned cf )
+{
+	const unsigned short*	q = &m_near[ cf * 8 ];
+	const unsigned short*	e = q + m_nnear[ cf ];
+	unsigned		n = 0;
+
+	for ( ; q < e; ++q ) {
+		const flower&	f = m_field[ *q ];
+
+		if ( f.is_growth( 3 ) && f.is_samekind( p ) && f.is_partner())
+			m_mates[ n++ ] = *q;
+	}
+	tally( counter_kind::Candidates, n );
+
+	return ( n == 0 ) ? nullptr : ( n == 1 ) ? &m_mates[ 0 ] : &m_mates[ rng( field_streams::Partner ).below( n ) ];
+}
+
+// -----------------------------------------------------------------------------
+void ff_dynamic::print( bool w_gene ) const
+{
+	fprintf( stderr, "Flower Field %s (%ux%u)\n", name(), m_rows, m_cols );
+	for ( unsigned r = 0; r < m_rows; ++r ) {
+		for ( unsigned c = 0; c < m_cols; ++c ) {
+			if ( const flower* p = get( index( r, c )))
+				p->print( false );
+			else if ( covered( r, c ))
+				fprintf( stderr, " xxxx" );
+			else
+				fprintf( stderr, " -   " );
+		}
+		putc( '\n', stderr );
+		if ( w_gene ) {
+			for ( unsigned c = 0; c < m_cols; ++c ) {
+				putc( ' ', stderr );
+				if ( const flower* p = get( index( r, c )))
 					p->print_gene();
 				else
 					fprintf( stderr, "    " );
@@ -1203,8 +2293,18 @@ class ff_storage : public flower_field<5,C>
 		super::recycle();
 		m_pq.open();
 	}
+	void save_state( snapshot& s ) const override
+	{
+		super::save_state( s );
+		m_pq.save_state( s );
+	}
+	void load_state( snapshot& s ) override
+	{
+		super::load_state( s );
+		m_pq.load_state( s );
+	}
 
-	bool put( flower* p ) override { return m_pq.put( p ); }
+	bool put( const flower& p ) override { return m_pq.put( p ); }
 	bool is_open() const override { return m_pq.is_open(); }
 
 	void plant() override { m_pq.plant(); }
@@ -1212,14 +2312,13 @@ class ff_storage : public flower_field<5,C>
 	{
 		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) {
 			if ( !put( super::pull( *i ))) {
-				if ( ff_base::m_verbose )
-					fprintf( stderr, "Warning: ff_storage(%s) is full\n", super::name());
+				super::trace( trace_event( trace_event::Full ));
 				break;
 			}
 		}
 	}
 
-	flower* pick() { return m_pq.pick(); }
+	flower pick() { return m_pq.pick(); }
 };
 
 typedef ff_storage<3>  ff_storage_1;
@@ -1238,7 +2337,7 @@ class ff_isolated : public flower_field<5,C>
 	typename super::plant_queue	m_pq;
 
    public:
-	ff_isolated( const char* nm ) : flower_field<5,5>( nm ), m_pq( this, { } )
+	ff_isolated( const char* nm ) : flower_field<5,C>( nm ), m_pq( this, { } )
 	{
 		for ( unsigned i = 0; i < C; i += 2 ) {
 			m_pq.set_order( { 2, i } );
@@ -1255,8 +2354,18 @@ class ff_isolated : public flower_field<5,C>
 		super::recycle();
 		m_pq.open();
 	}
+	void save_state( snapshot& s ) const override
+	{
+		super::save_state( s );
+		m_pq.save_state( s );
+	}
+	void load_state( snapshot& s ) override
+	{
+		super::load_state( s );
+		m_pq.load_state( s );
+	}
 
-	bool put( flower* p ) override { return m_pq.put( p ); }
+	bool put( const flower& p ) override { return m_pq.put( p ); }
 	bool is_open() const override { return m_pq.is_open(); }
 
 	void plant() override { m_pq.plant(); }
@@ -1264,14 +2373,16 @@ class ff_isolated : public flower_field<5,C>
 	{
 		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) {
 			if ( !super::put( super::pull( *i ))) {
-				if ( ff_base::m_verbose )
-					fprintf( stderr, "Warning: ff_isolated(%s) is full\n", super::name());
+				trace_event	e( trace_event::Full );
+
+				e.flags = trace_event::Isolated;
+				super::trace( e );
 				break;
 			}
 		}
 	}
 
-	flower* pick() { return m_pq.pick(); }
+	flower pick() { return m_pq.pick(); }
 };	
 
 typedef ff_isolated<3>  ff_isolated_1;
@@ -1306,8 +2417,18 @@ class ff_shbase : public flower_field<5,C>
 		super::recycle();
 		m_pq.open();
 	}
+	void save_state( snapshot& s ) const override
+	{
+		super::save_state( s );
+		m_pq.save_state( s );
+	}
+	void load_state( snapshot& s ) override
+	{
+		super::load_state( s );
+		m_pq.load_state( s );
+	}
 
-	bool put( flower* p ) override { return m_pq.put( p ); }
+	bool put( const flower& p ) override { return m_pq.put( p ); }
 	bool is_open() const override { return m_pq.is_open(); }
 
 	void plant() override { m_pq.plant(); }
@@ -1330,18 +2451,24 @@ class ff_shbase : public flower_field<5,C>
 	{
 		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) {
 
-			flower* f = super::pull( *i );
+			flower	f = super::pull( *i );
 			bool	hv = false;
 
+			uint8_t	to = trace_event::None;
+
 			for ( auto p = m_hp.begin(); p != m_hp.end(); ++p ) {
-				if ( f->is_color( p->color )) {
-					hv = p->field->put( f );
+				if ( f.is_color( p->color )) {
+					if (( hv = p->field->put( f ))) to = p->field->id();
 					break;
 				}
 			}
-			if ( !hv && ff_base::m_verbose ) {
-				fprintf( stderr, "Info: harvest from %s, scrap ", super::name());
-				f->print( true, true );
+			if ( super::is_traced()) {
+				trace_event	e( trace_event::Harvest );
+
+				e.set( 0, f, *i );
+				e.aux   = to;
+				e.flags = trace_event::WithGene;
+				super::trace( e );
 			}
 		}
 	}
@@ -1466,13 +2593,25 @@ class ff_phbase : public flower_field<5,C>
 		m_q1.open();
 		m_q2.open();
 	}
+	void save_state( snapshot& s ) const override
+	{
+		super::save_state( s );
+		m_q1.save_state( s );
+		m_q2.save_state( s );
+	}
+	void load_state( snapshot& s ) override
+	{
+		super::load_state( s );
+		m_q1.load_state( s );
+		m_q2.load_state( s );
+	}
 
-	bool put( flower* p ) override
+	bool put( const flower& p ) override
 	{
 		bool	r = false;
 
-		if      ( p->is_color( m_c1 )) r = m_q1.put( p );
-		else if ( p->is_color( m_c2 )) r = m_q2.put( p );
+		if      ( p.is_color( m_c1 )) r = m_q1.put( p );
+		else if ( p.is_color( m_c2 )) r = m_q2.put( p );
 
 		return r;
 	}
@@ -1507,18 +2646,23 @@ class ff_phbase : public flower_field<5,C>
 	{
 		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) {
 
-			flower* f = super::pull( *i );
+			flower	f = super::pull( *i );
 			bool	hv = false;
 
+			uint8_t	to = trace_event::None;
+
 			for ( auto p = m_hp.begin(); p != m_hp.end(); ++p ) {
-				if ( f->is_color( p->color )) {
-					hv = p->field->put( f );
+				if ( f.is_color( p->color )) {
+					if (( hv = p->field->put( f ))) to = p->field->id();
 					break;
 				}
 			}
-			if ( !hv && ff_base::m_verbose ) {
-				fprintf( stderr, "Info: harvest from %s, scrap ", super::m_name.c_str());
-				f->print( false, true, stderr );
+			if ( super::is_traced()) {
+				trace_event	e( trace_event::Harvest );
+
+				e.set( 0, f, *i );
+				e.aux = to;
+				super::trace( e );
 			}
 		}
 	}
@@ -1712,13 +2856,25 @@ class ff_swapHybrid: public flower_field<5,C>
 		m_q1.open();
 		m_q2.open();
 	}
+	void save_state( snapshot& s ) const override
+	{
+		super::save_state( s );
+		m_q1.save_state( s );
+		m_q2.save_state( s );
+	}
+	void load_state( snapshot& s ) override
+	{
+		super::load_state( s );
+		m_q1.load_state( s );
+		m_q2.load_state( s );
+	}
 
-	bool put( flower* p ) override
+	bool put( const flower& p ) override
 	{
 		bool	r = false;
 
-		if      ( p->is_color( m_ck )) 		  r = m_q1.put( p );
-		else if ( p->is_color( m_sp[ 0 ].color )) r = m_q2.put( p );
+		if      ( p.is_color( m_ck )) 		  r = m_q1.put( p );
+		else if ( p.is_color( m_sp[ 0 ].color )) r = m_q2.put( p );
 
 		return r;
 	}
@@ -1755,22 +2911,22 @@ class ff_swapHybrid: public flower_field<5,C>
 		for ( unsigned i = 0; i < MaxTests; ++i ) {
 
 			flower*		kr = super::get( kernel( i ));	
-			flower*&	ee = super::get( swappee( i ));
+			flower*		ee = super::get( swappee( i ));
 
 			if ( kr && ee ) {	
-				flower*		     er = super::pull( swapper( i, 0 ));
-				if ( er == nullptr ) er = super::pull( swapper( i, 1 ));
+				flower		er = super::pull( swapper( i, 0 ));
+				if ( !er ) er = super::pull( swapper( i, 1 ));
 
 				if ( er ) {
 					for ( unsigned p = 0; p < m_plans; ++p ) {
 
 						if ( ee->is_color( m_sp[ p ].color ) &&
-						     er->is_color( m_sp[ p ].next )) {
+						     er.is_color( m_sp[ p ].next )) {
 
 							if ( ff_base* ff = m_sp[ p ].opt ) {
 								ff->put( er );
 							} else {
-								ee = er;
+								*ee = er;
 							}
 							break;
 						}
@@ -1837,7 +2993,7 @@ class ff_hybridTest: public flower_field<R,C>
 	ff_base*			m_fSucc;
 	ff_base*			m_fFail;
 
-	flower*				m_qs[ MaxTests ];
+	flower				m_qs[ MaxTests ];
 	unsigned			m_pos;
 	unsigned			m_tests;
 	unsigned			m_inTest;
@@ -1889,13 +3045,31 @@ class ff_hybridTest: public flower_field<R,C>
 
 		m_qt.open();
 	}
-
-	bool put_tester( flower* p )
+	void save_state( snapshot& s ) const override
+	{
+		super::save_state( s );
+		m_qt.save_state( s );
+		s.put( m_qs );
+		s.put( m_pos );
+		s.put( m_tests );
+		s.put( m_inTest );
+	}
+	void load_state( snapshot& s ) override
+	{
+		super::load_state( s );
+		m_qt.load_state( s );
+		s.get( m_qs );
+		s.get( m_pos );
+		s.get( m_tests );
+		s.get( m_inTest );
+	}
+
+	bool put_tester( const flower& p )
 	{
 		if ( m_tests < MaxTests ) m_tests++;
 		return m_qt.put( p );
 	}
-        bool put_sample( flower* p ) 
+        bool put_sample( const flower& p ) 
 	{
 		if ( m_pos < MaxTests ) {
 			m_qs[ m_pos++ ] = p;
@@ -1904,7 +3078,7 @@ class ff_hybridTest: public flower_field<R,C>
 			return false;
 		}
 	}
-        bool put( flower* p ) override { return put_sample( p ); }
+        bool put( const flower& p ) override { return put_sample( p ); }
 	bool is_open() const override { return m_pos < MaxTests; }
 
         void plant() override
@@ -1913,8 +3087,8 @@ class ff_hybridTest: public flower_field<R,C>
 
 		if ( 0 < m_pos && m_inTest < m_tests ) {
 			for ( unsigned u = 0; u < m_tests; ++u ) {
-				flower*& f = super::get( sample( u ));
-				if ( f == nullptr ) {
+				flower& f = super::cell( sample( u ));
+				if ( !f ) {
 					f = m_qs[ --m_pos ];
 					++m_inTest;
 					break;
@@ -1944,15 +3118,15 @@ class ff_hybridTest: public flower_field<R,C>
 
 		for ( unsigned u = 0; u < m_tests; ++u ) {
 
-			if ( flower* f = super::get( sample( u ))) {
+			if ( super::get( sample( u ))) {
 				bool ts = false;
 				int  cf = 0;
 
 				for ( unsigned j = 0; j < 4; ++j ) {
-					if ( flower* r = super::pull( result( u, j ))) {
-						if ( r->is_color( super::get( tester( u, 0 )))) {
+					if ( flower r = super::pull( result( u, j ))) {
+						if ( r.is_color( super::get( tester( u, 0 )))) {
 							ts = true;
-						} else if ( r->is_color( m_cSucc )) {
+						} else if ( r.is_color( m_cSucc )) {
 							cf = 1;
 						} else {
 							cf = -1;
@@ -1960,7 +3134,7 @@ class ff_hybridTest: public flower_field<R,C>
 					}
 				}
 				if ( cf != 0 || ts == true ) {
-					f = super::pull( sample( u ));
+					flower f = super::pull( sample( u ));
 					if ( 0 <= cf ) {
 						assert( m_fSucc );
 						m_fSucc->put( f );
@@ -1983,11 +3157,661 @@ typedef ff_hybridTest<11,11> ff_hybridTest_6;		//  9 samples
 typedef ff_hybridTest<11,15> ff_hybridTest_8;		// 12 samples
 typedef ff_hybridTest<11,19> ff_hybridTest_10;		// 15 samples are tested in the same time.
 
+//
+// Lockstep multi-trial engine ( for the layout studies )
+// -----------------------------------------------------------------------------
+
+// xoshiro256** of L lanes in structure of arrays, SIMD by AVX2 or SSE2 if available
+// -----------------------------------------------------------------------------
+template <unsigned L>
+class lane_engine
+{
+	static_assert( L % 4 == 0, "lanes must be a multiple of 4" );
+
+	alignas( 32 ) unsigned long long	m_s[ 4 ][ L ];
+	alignas( 32 ) unsigned long long	m_r[ L ];
+
+    public:
+	// each lane is seeded by the scalar stream of its own trial
+	void seed( unsigned l, random_engine& e ) { for ( unsigned k = 0; k < 4; ++k ) m_s[ k ][ l ] = e(); }
+
+	// one draw for every lane into m_r
+	void next();
+
+	// 0 .. n-1 for every lane, same as random_engine::below()
+	template <typename T>
+	void below( unsigned n, T* r )
+	{
+		next();
+		for ( unsigned l = 0; l < L; ++l ) r[ l ] = ((( m_r[ l ] >> 32 ) * n ) >> 32 );
+	}
+};
+
+template <unsigned L>
+inline void lane_engine<L>::next()
+{
+	unsigned long long* s0 = m_s[ 0 ];
+	unsigned long long* s1 = m_s[ 1 ];
+	unsigned long long* s2 = m_s[ 2 ];
+	unsigned long long* s3 = m_s[ 3 ];
+	unsigned		l  = 0;
+
+#if defined( __AVX2__ )
+	for ( ; l + 4 <= L; l += 4 ) {
+		__m256i	a = _mm256_load_si256( reinterpret_cast<const __m256i*>( s0 + l ));
+		__m256i	b = _mm256_load_si256( reinterpret_cast<const __m256i*>( s1 + l ));
+		__m256i	c = _mm256_load_si256( reinterpret_cast<const __m256i*>( s2 + l ));
+		__m256i	d = _mm256_load_si256( reinterpret_cast<const __m256i*>( s3 + l ));
+		__m256i	x = _mm256_add_epi64( _mm256_slli_epi64( b, 2 ), b );			// s1 * 5
+		x = _mm256_or_si256( _mm256_slli_epi64( x, 7 ), _mm256_srli_epi64( x, 57 ));	// rotl 7
+		x = _mm256_add_epi64( _mm256_slli_epi64( x, 3 ), x );				// * 9
+		__m256i	t = _mm256_slli_epi64( b, 17 );
+
+		c = _mm256_xor_si256( c, a );
+		d = _mm256_xor_si256( d, b );
+		b = _mm256_xor_si256( b, c );
+		a = _mm256_xor_si256( a, d );
+		c = _mm256_xor_si256( c, t );
+		d = _mm256_or_si256( _mm256_slli_epi64( d, 45 ), _mm256_srli_epi64( d, 19 ));
+
+		_mm256_store_si256( reinterpret_cast<__m256i*>( s0 + l ), a );
+		_mm256_store_si256( reinterpret_cast<__m256i*>( s1 + l ), b );
+		_mm256_store_si256( reinterpret_cast<__m256i*>( s2 + l ), c );
+		_mm256_store_si256( reinterpret_cast<__m256i*>( s3 + l ), d );
+		_mm256_store_si256( reinterpret_cast<__m256i*>( m_r + l ), x );
+	}
+#elif defined( __SSE2__ )
+	for ( ; l + 2 <= L; l += 2 ) {
+		__m128i	a = _mm_load_si128( reinterpret_cast<const __m128i*>( s0 + l ));
+		__m128i	b = _mm_load_si128( reinterpret_cast<const __m128i*>( s1 + l ));
+		__m128i	c = _mm_load_si128( reinterpret_cast<const __m128i*>( s2 + l ));
+		__m128i	d = _mm_load_si128( reinterpret_cast<const __m128i*>( s3 + l ));
+		__m128i	x = _mm_add_epi64( _mm_slli_epi64( b, 2 ), b );			// s1 * 5
+		x = _mm_or_si128( _mm_slli_epi64( x, 7 ), _mm_srli_epi64( x, 57 ));		// rotl 7
+		x = _mm_add_epi64( _mm_slli_epi64( x, 3 ), x );				// * 9
+		__m128i	t = _mm_slli_epi64( b, 17 );
+
+		c = _mm_xor_si128( c, a );
+		d = _mm_xor_si128( d, b );
+		b = _mm_xor_si128( b, c );
+		a = _mm_xor_si128( a, d );
+		c = _mm_xor_si128( c, t );
+		d = _mm_or_si128( _mm_slli_epi64( d, 45 ), _mm_srli_epi64( d, 19 ));
+
+		_mm_store_si128( reinterpret_cast<__m128i*>( s0 + l ), a );
+		_mm_store_si128( reinterpret_cast<__m128i*>( s1 + l ), b );
+		_mm_store_si128( reinterpret_cast<__m128i*>( s2 + l ), c );
+		_mm_store_si128( reinterpret_cast<__m128i*>( s3 + l ), d );
+		_mm_store_si128( reinterpret_cast<__m128i*>( m_r + l ), x );
+	}
+#endif
+	for ( ; l < L; ++l ) {
+		unsigned long long x = s1[ l ] * 5;
+		unsigned long long t = s1[ l ] << 17;
+
+		m_r[ l ] = (( x << 7 ) | ( x >> 57 )) * 9;
+		s2[ l ] ^= s0[ l ];
+		s3[ l ] ^= s1[ l ];
+		s1[ l ] ^= s2[ l ];
+		s0[ l ] ^= s3[ l ];
+		s2[ l ] ^= t;
+		s3[ l ] = ( s3[ l ] << 45 ) | ( s3[ l ] >> 19 );
+	}
+}
+
+// daily watering of n bytes of the lanes: w = min( w + 1, 20 ), a = hybrid_ratio( w, v ) > roll
+// -----------------------------------------------------------------------------
+inline void lanes_refresh( unsigned char* w, const unsigned char* roll, unsigned char* a, unsigned n, visitor v )
+{
+	const unsigned char	bonus = hybrid_ratio( 3, v ) - 5;	// hybrid_ratio( w, v ) = bonus + 5 * max( w, 3 ) - 10
+	unsigned		i = 0;
+
+#if defined( __AVX2__ )
+	const __m256i	one   = _mm256_set1_epi8( 1 );
+	const __m256i	three = _mm256_set1_epi8( 3 );
+	const __m256i	maxw  = _mm256_set1_epi8( MaxWaterCount );
+	const __m256i	base  = _mm256_set1_epi8( bonus - 10 );
+	const __m256i	zero  = _mm256_setzero_si256();
+
+	for ( ; i + 32 <= n; i += 32 ) {
+		__m256i	x = _mm256_load_si256( reinterpret_cast<const __m256i*>( w + i ));
+		x = _mm256_min_epu8( _mm256_adds_epu8( x, one ), maxw );
+		_mm256_store_si256( reinterpret_cast<__m256i*>( w + i ), x );
+
+		__m256i	y = _mm256_max_epu8( x, three );
+		__m256i	y4 = _mm256_add_epi8( y, y );
+		y4 = _mm256_add_epi8( y4, y4 );
+		__m256i	r = _mm256_add_epi8( _mm256_add_epi8( y4, y ), base );		// ratio <= 165
+		__m256i	g = _mm256_subs_epu8( r, _mm256_load_si256( reinterpret_cast<const __m256i*>( roll + i )));
+
+		_mm256_store_si256( reinterpret_cast<__m256i*>( a + i ),
+				    _mm256_andnot_si256( _mm256_cmpeq_epi8( g, zero ), one ));
+	}
+#elif defined( __SSE2__ )
+	const __m128i	one   = _mm_set1_epi8( 1 );
+	const __m128i	three = _mm_set1_epi8( 3 );
+	const __m128i	maxw  = _mm_set1_epi8( MaxWaterCount );
+	const __m128i	base  = _mm_set1_epi8( bonus - 10 );
+	const __m128i	zero  = _mm_setzero_si128();
+
+	for ( ; i + 16 <= n; i += 16 ) {
+		__m128i	x = _mm_load_si128( reinterpret_cast<const __m128i*>( w + i ));
+		x = _mm_min_epu8( _mm_adds_epu8( x, one ), maxw );
+		_mm_store_si128( reinterpret_cast<__m128i*>( w + i ), x );
+
+		__m128i	y = _mm_max_epu8( x, three );
+		__m128i	y4 = _mm_add_epi8( y, y );
+		y4 = _mm_add_epi8( y4, y4 );
+		__m128i	r = _mm_add_epi8( _mm_add_epi8( y4, y ), base );		// ratio <= 165
+		__m128i	g = _mm_subs_epu8( r, _mm_load_si128( reinterpret_cast<const __m128i*>( roll + i )));
+
+		_mm_store_si128( reinterpret_cast<__m128i*>( a + i ), _mm_andnot_si128( _mm_cmpeq_epi8( g, zero ), one ));
+	}
+#endif
+	for ( ; i < n; ++i ) {
+		if ( w[ i ] < MaxWaterCount ) ++w[ i ];
+		a[ i ] = hybrid_ratio( w[ i ], v ) > roll[ i ];
+	}
+}
+
+// -----------------------------------------------------------------------------
+template <unsigned R, unsigned C, unsigned L>
+class ff_lockstep
+{
+	// runs L independent trials ( lanes ) of one layout at the same time.
+	//
+	// the layout is a flower field of mature flowers which are hydrated every day, and whose
+	// hybrids are harvested on the next day ( ff_layout of layout1/layout2 ), so the field is
+	// the same layout at every daily refresh. watering counters, hybrid_ratio() thresholds and
+	// the random draws for them and for the process order are computed for all lanes by SIMD,
+	// then each lane walks its own process order for the hybrids as daily_refresh() does.
+
+	static_assert( R * C <= 256, "flower numbers are unsigned char" );
+
+	unsigned		m_n;				// number of flowers
+	flower			m_flower[ R * C ];		// layout
+	unsigned char		m_nspace[ R * C ];
+	unsigned short		m_space[ R * C ][ 8 ];		// free cells around the flower, in the scan order
+	unsigned char		m_nmate[ R * C ];
+	unsigned char		m_mate[ R * C ][ 8 ];		// same kind flowers around the flower
+
+	// per flower x lane
+	alignas( 32 ) unsigned char	m_water[ R * C ][ L ];
+	alignas( 32 ) unsigned char	m_partner[ R * C ][ L ];
+	alignas( 32 ) unsigned char	m_roll[ R * C ][ L ];
+	alignas( 32 ) unsigned char	m_appl[ R * C ][ L ];		// is_applicable()
+
+	// per lane
+	unsigned char		m_order[ L ][ R * C ];
+	unsigned		m_done[ L ][ R * C ];		// processed day of the flower
+	random_engine		m_rng[ L ];
+	lane_engine<L>		m_lanes;
+	unsigned		m_day;
+
+    public:
+	ff_lockstep( const flower_field<R,C>& f ) : m_n( 0 ), m_day( 0 )
+	{
+		unsigned short	no[ R * C ];
+
+		for ( unsigned i = 0; i < R * C; ++i ) {
+			if ( const flower* p = f.get( i )) {
+				assert( p->is_growth( 3 ));
+
+				no[ i ] = m_n;
+				m_flower[ m_n++ ] = *p;
+			} else {
+				no[ i ] = R * C;
+			}
+		}
+		for ( unsigned r = 0, k = 0; r < R; ++r ) {
+			for ( unsigned c = 0; c < C; ++c ) {
+				if ( no[ r * C + c ] == R * C ) continue;
+
+				m_nspace[ k ] = m_nmate[ k ] = 0;
+				for ( unsigned cc = ( 0 < c ) ? c - 1 : 0; cc < C && cc <= c + 1; ++cc ) {
+					for ( unsigned rr = ( 0 < r ) ? r - 1 : 0; rr < R && rr <= r + 1; ++rr ) {
+						unsigned	j = rr * C + cc;
+
+						if (( rr == r && cc == c ) || f.covered( { rr, cc } )) continue;
+						if ( no[ j ] == R * C )
+							m_space[ k ][ m_nspace[ k ]++ ] = j;
+						else if ( m_flower[ no[ j ]].is_samekind( &m_flower[ k ] ))
+							m_mate[ k ][ m_nmate[ k ]++ ] = no[ j ];
+					}
+				}
+				++k;
+			}
+		}
+	}
+
+	// lane l runs the trial ( seed, first + l )
+	void seed( unsigned long long seed, unsigned first )
+	{
+		for ( unsigned l = 0; l < L; ++l ) {
+			m_rng[ l ].seed( seed, first + l );
+			m_lanes.seed( l, m_rng[ l ] );
+			for ( unsigned k = 0; k < m_n; ++k ) {
+				m_order[ l ][ k ] = k;
+				m_done[ l ][ k ] = 0;
+			}
+		}
+		memset( m_water, 0, sizeof( m_water ));
+		m_day = 0;
+	}
+
+	// h.tally( const flower& ) is called for each hybrid
+	template <typename H>
+	void run( unsigned days, visitor v, H& h )
+	{
+		while ( days-- ) refresh( v, h );
+	}
+
+	unsigned flowers() const { return m_n; }
+
+    private:
+	template <typename H> void refresh( visitor v, H& h );
+};
+
+template <unsigned R, unsigned C, unsigned L>
+template <typename H>
+void ff_lockstep<R,C,L>::refresh( visitor v, H& h )
+{
+	// all lanes: daily_init(), increment_water() and the rolls of is_applicable()
+	memset( m_partner, 1, sizeof( m_partner[ 0 ] ) * m_n );
+	for ( unsigned k = 0; k < m_n; ++k ) m_lanes.below( 100, m_roll[ k ] );
+	lanes_refresh( &m_water[ 0 ][ 0 ], &m_roll[ 0 ][ 0 ], &m_appl[ 0 ][ 0 ], m_n * L, v );
+
+	// all lanes: process order by Fisher-Yates
+	unsigned char	j[ L ];
+
+	for ( unsigned i = m_n; 1 < i; --i ) {
+		m_lanes.below( i, j );
+		for ( unsigned l = 0; l < L; ++l ) {
+			unsigned char t = m_order[ l ][ i - 1 ];
+
+			m_order[ l ][ i - 1 ] = m_order[ l ][ j[ l ]];
+			m_order[ l ][ j[ l ]] = t;
+		}
+	}
+
+	// lane by lane: hybrids
+	++m_day;
+	for ( unsigned l = 0; l < L; ++l ) {
+		random_engine&		e = m_rng[ l ];
+		bitboard<R * C>		taken;		// planting spaces used today
+		unsigned short		space[ 8 ];
+		unsigned char		mate[ 8 ];
+
+		for ( unsigned i = 0; i < m_n; ++i ) {
+			unsigned	k = m_order[ l ][ i ];
+
+			m_done[ l ][ k ] = m_day;
+			if ( !m_appl[ k ][ l ] || !m_partner[ k ][ l ] ) continue;
+
+			unsigned	ns = 0;
+			unsigned	nm = 0;
+
+			for ( unsigned s = 0; s < m_nspace[ k ]; ++s ) {
+				if ( !taken.test( m_space[ k ][ s ] )) space[ ns++ ] = m_space[ k ][ s ];
+			}
+			if ( ns == 0 ) continue;
+
+			unsigned	ps = space[ e.below( ns ) ];
+
+			for ( unsigned s = 0; s < m_nmate[ k ]; ++s ) {
+				if ( m_partner[ m_mate[ k ][ s ]][ l ] ) mate[ nm++ ] = m_mate[ k ][ s ];
+			}
+
+			const flower*	p = ( nm == 0 ) ? nullptr : &m_flower[ mate[ ( nm == 1 ) ? 0 : e.below( nm ) ]];
+
+			h.tally( m_flower[ k ].hybrid( p, e ));
+			taken.set( ps );
+
+			m_partner[ k ][ l ] = 0;
+			m_water[ k ][ l ] = 0;
+			if ( p ) {
+				unsigned	q = p - m_flower;
+
+				// the partner which is not processed yet will be watered after the reset
+				m_partner[ q ][ l ] = 0;
+				m_water[ q ][ l ] = ( m_done[ l ][ q ] == m_day ) ? 0 : 1;
+			}
+		}
+	}
+}
+
 //
 // Simulator
 // -----------------------------------------------------------------------------
 const unsigned DefaultMaxSteps = 1000;
 
+// common options of the simulators ( --xxx )
+// -----------------------------------------------------------------------------
+struct sim_options
+{
+	unsigned long long	seed;		// --seed n
+	unsigned		trial;		// --trial n: the first trial number
+	double			ci;		// --ci w: run the regression until the 95% half-width of the average is w
+	const char*		record;		// --record file: append the result of each trial to the file
+	const char*		checkpoint;	// --checkpoint file: save the regression periodically
+	bool			resume;		// --resume: continue the regression saved in the checkpoint
+	unsigned		fork_day;	// --fork day n: n continuations from the state of the trial on the day
+	unsigned		forks;
+	const char*		trace;		// --trace file: event trace of the simulation
+	bool			verbose;	// --verbose: the events to stderr
+	bool			profile;	// --profile: time of each field and phase of the steps
+
+	sim_options()
+		: seed( random_seed()), trial( 0 ), ci( 0.0 ), record( nullptr ), checkpoint( nullptr ), resume( false ),
+		  fork_day( 0 ), forks( 0 ), trace( nullptr ), verbose( false ), profile( false )
+	{ }
+
+	// parse argv[ i ] ( and its argument ), return false if it is not a common option
+	bool parse( int argc, char** argv, int& i )
+	{
+		if ( i + 1 < argc && strcmp( argv[ i ], "--seed" ) == 0 ) {
+			seed = strtoull( argv[ ++i ], nullptr, 0 );
+		} else if ( i + 1 < argc && strcmp( argv[ i ], "--trial" ) == 0 ) {
+			trial = strtoul( argv[ ++i ], nullptr, 0 );
+		} else if ( i + 1 < argc && strcmp( argv[ i ], "--ci" ) == 0 ) {
+			ci = strtod( argv[ ++i ], nullptr );
+		} else if ( i + 1 < argc && strcmp( argv[ i ], "--record" ) == 0 ) {
+			record = argv[ ++i ];
+		} else if ( i + 1 < argc && strcmp( argv[ i ], "--checkpoint" ) == 0 ) {
+			checkpoint = argv[ ++i ];
+		} else if ( strcmp( argv[ i ], "--resume" ) == 0 ) {
+			resume = true;
+		} else if ( i + 2 < argc && strcmp( argv[ i ], "--fork" ) == 0 ) {
+			fork_day = strtoul( argv[ ++i ], nullptr, 0 );
+			forks    = strtoul( argv[ ++i ], nullptr, 0 );
+		} else if ( i + 1 < argc && strcmp( argv[ i ], "--trace" ) == 0 ) {
+			trace = argv[ ++i ];
+		} else if ( strcmp( argv[ i ], "--verbose" ) == 0 ) {
+			verbose = true;
+		} else if ( strcmp( argv[ i ], "--profile" ) == 0 ) {
+			profile = true;
+		} else {
+			return false;
+		}
+		return true;
+	}
+	static const char* usage() { return "[--seed n][--trial n][--ci half-width][--record file][--checkpoint file [--resume]][--fork day n][--trace file][--verbose][--profile]"; }
+};
+
+// Statistics of steps
+// -----------------------------------------------------------------------------
+//	mean and variance are accumulated by Welford's method in double, and the steps are
+//	counted in a histogram of 0..maxsteps for the exact percentiles. the memory does not
+//	grow with the number of trials.
+class step_stat
+{
+	unsigned		m_n;
+	unsigned		m_min;
+	unsigned		m_max;
+	double			m_mean;
+	double			m_m2;		// sum of the squared deviations from the mean
+	std::vector<unsigned>	m_hist;		// m_hist[ s ]: trials which took s steps
+
+    public:
+	step_stat( unsigned maxsteps = DefaultMaxSteps )
+		: m_n( 0 ), m_min( maxsteps ), m_max( 0 ), m_mean( 0.0 ), m_m2( 0.0 ), m_hist( maxsteps + 1, 0 )
+	{ }
+
+	void add( unsigned s )
+	{
+		double	d = s - m_mean;
+
+		if ( s < m_min ) m_min = s;
+		if ( m_max < s ) m_max = s;
+		++m_n;
+		m_mean += d / m_n;
+		m_m2   += d * ( s - m_mean );
+		++m_hist[ ( s < m_hist.size()) ? s : m_hist.size() - 1 ];
+	}
+	void merge( const step_stat& t )
+	{
+		// combine the partial results ( Chan et al. )
+		if ( t.m_n == 0 ) return;
+
+		double	n = 1.0 * m_n + t.m_n;
+		double	d = t.m_mean - m_mean;
+
+		if ( t.m_min < m_min ) m_min = t.m_min;
+		if ( m_max < t.m_max ) m_max = t.m_max;
+		m_mean += d * t.m_n / n;
+		m_m2   += t.m_m2 + d * d * m_n * t.m_n / n;
+		m_n    += t.m_n;
+
+		if ( m_hist.size() < t.m_hist.size()) m_hist.resize( t.m_hist.size(), 0 );
+		for ( size_t s = 0; s < t.m_hist.size(); ++s ) m_hist[ s ] += t.m_hist[ s ];
+	}
+
+	unsigned count() const { return m_n; }
+	unsigned min() const { return m_min; }
+	unsigned max() const { return m_max; }
+	double mean() const { return m_mean; }
+	double sigma() const { return ( 0 < m_n ) ? sqrt( m_m2 / m_n ) : 0.0; }
+
+	// half-width of the 95% confidence interval of the average
+	double half_width() const { return ( 1 < m_n ) ? 1.96 * sqrt( m_m2 / ( m_n - 1 ) / m_n ) : HUGE_VAL; }
+
+	// the smallest steps s such that p of the trials took s steps or less ( 0 < p <= 1 )
+	unsigned percentile( double p ) const
+	{
+		unsigned long long	k = (unsigned long long) ceil( p * m_n );
+		unsigned long long	c = 0;
+
+		if ( k == 0 ) k = 1;
+		for ( size_t s = 0; s < m_hist.size(); ++s ) {
+			if ( k <= ( c += m_hist[ s ] )) return s;
+		}
+		return m_max;
+	}
+
+	// binary image for the checkpoint
+	bool save( FILE* fp ) const
+	{
+		uint32_t	h[ 4 ] = { m_n, m_min, m_max, (uint32_t) m_hist.size() };
+		double		d[ 2 ] = { m_mean, m_m2 };
+
+		return fwrite( h, sizeof( h ), 1, fp ) == 1 && fwrite( d, sizeof( d ), 1, fp ) == 1 &&
+		       fwrite( m_hist.data(), sizeof( unsigned ), m_hist.size(), fp ) == m_hist.size();
+	}
+	bool load( FILE* fp )
+	{
+		uint32_t	h[ 4 ];
+		double		d[ 2 ];
+
+		if ( fread( h, sizeof( h ), 1, fp ) != 1 || fread( d, sizeof( d ), 1, fp ) != 1 ) return false;
+
+		m_n    = h[ 0 ];
+		m_min  = h[ 1 ];
+		m_max  = h[ 2 ];
+		m_mean = d[ 0 ];
+		m_m2   = d[ 1 ];
+		m_hist.resize( h[ 3 ] );
+
+		return fread( m_hist.data(), sizeof( unsigned ), m_hist.size(), fp ) == m_hist.size();
+	}
+
+	void print( const char* label, FILE* fp = stdout ) const
+	{
+		fprintf( fp, "%smin = %u, max = %u, average = %f, sigma = %f, p50 = %u, p90 = %u, p99 = %u\n",
+			 label, m_min, m_max, m_mean, sigma(), percentile( 0.5 ), percentile( 0.9 ), percentile( 0.99 ));
+	}
+};
+
+// Trial records
+// -----------------------------------------------------------------------------
+//	the results of the regression trials are appended to a file in blocks of columns,
+//	the trials of a block are in the order of the trial number.
+//
+//	file header:	"ACNHREC1", number of columns ( u32 ), column names ( 16 bytes each )
+//	block:		number of records n ( u32 ), 0 ( u32 ), seed ( u64 ), n values ( u32 ) of each column
+struct trial_record
+{
+	uint32_t	trial;
+	uint32_t	steps;
+	uint32_t	first_blue;	// steps until the first blue rose, 0 if none
+	uint32_t	field_units;	// peak of the field units used
+	uint32_t	tests;		// peak of the flowers under the test
+
+	static const unsigned	Columns = 5;
+
+	static uint32_t trial_record::* column( unsigned k )
+	{
+		static uint32_t trial_record::* const	m[ Columns ] = {
+			&trial_record::trial, &trial_record::steps, &trial_record::first_blue,
+			&trial_record::field_units, &trial_record::tests };
+		return m[ k ];
+	}
+	static const char* column_name( unsigned k )
+	{
+		static const char* const	n[ Columns ] = { "trial", "steps", "first_blue", "field_units", "tests" };
+		return n[ k ];
+	}
+};
+
+class record_file
+{
+	FILE*		m_fp;
+	unsigned	m_columns;	// columns in the file ( a newer file may have more )
+	std::string	m_path;
+	long		m_end;		// size of the file opened for reading
+	bool		m_failed;	// read() found a corrupt or truncated block
+
+	static const char*	Magic;
+	static const unsigned	NameLength = 16;
+
+    public:
+	record_file() : m_fp( nullptr ), m_columns( 0 ), m_end( 0 ), m_failed( false ) { }
+	~record_file() { close(); }
+
+	// open for append, the header is written to a new file and checked for an existing one.
+	// the records after size are discarded if size is given ( resumed regression ).
+	bool append( const char* path, long size = -1 )
+	{
+		if ( FILE* fp = fopen( path, "rb" )) {
+			bool	ok = read_header( fp );
+
+			fclose( fp );
+			if ( !ok || m_columns != trial_record::Columns ) {
+				fprintf( stderr, "Error: %s is not a record file of this version\n", path );
+				return false;
+			}
+			if ( 0 < size && truncate( path, size ) != 0 ) {
+				fprintf( stderr, "Error: cannot truncate %s\n", path );
+				return false;
+			}
+			if (( m_fp = fopen( path, "ab" ))) fseek( m_fp, 0, SEEK_END );
+		} else if (( m_fp = fopen( path, "wb" ))) {
+			char	name[ NameLength ];
+			uint32_t	n = m_columns = trial_record::Columns;
+
+			fwrite( Magic, 1, 8, m_fp );
+			fwrite( &n, sizeof( n ), 1, m_fp );
+			for ( unsigned k = 0; k < n; ++k ) {
+				strncpy( name, trial_record::column_name( k ), NameLength );
+				fwrite( name, 1, NameLength, m_fp );
+			}
+		}
+		if ( !m_fp ) fprintf( stderr, "Error: cannot open %s\n", path );
+
+		return m_fp != nullptr;
+	}
+	bool open( const char* path )
+	{
+		m_path   = path;
+		m_failed = false;
+		if (( m_fp = fopen( path, "rb" )) && fseek( m_fp, 0, SEEK_END ) == 0 && 0 <= ( m_end = ftell( m_fp ))
+		    && fseek( m_fp, 0, SEEK_SET ) == 0 && read_header( m_fp )) return true;
+
+		fprintf( stderr, "Error: %s is not a record file\n", path );
+		close();
+
+		return false;
+	}
+	void close()
+	{
+		if ( m_fp ) fclose( m_fp );
+		m_fp = nullptr;
+	}
+	long size() const { return m_fp ? ftell( m_fp ) : -1; }
+	bool failed() const { return m_failed; }
+
+	void write( unsigned long long seed, const std::vector<trial_record>& r )
+	{
+		uint32_t		h[ 2 ] = { (uint32_t) r.size(), 0 };
+		uint64_t		sd = seed;
+		std::vector<uint32_t>	col( r.size());
+
+		if ( !m_fp || r.empty()) return;
+
+		fwrite( h, sizeof( h ), 1, m_fp );
+		fwrite( &sd, sizeof( sd ), 1, m_fp );
+		for ( unsigned k = 0; k < trial_record::Columns; ++k ) {
+			for ( size_t i = 0; i < r.size(); ++i ) col[ i ] = r[ i ].*trial_record::column( k );
+			fwrite( col.data(), sizeof( uint32_t ), col.size(), m_fp );
+		}
+		fflush( m_fp );
+	}
+	// read the next block, return false at the end of the file or on an error ( failed() )
+	bool read( unsigned long long& seed, std::vector<trial_record>& r )
+	{
+		uint32_t		h[ 2 ];
+		uint64_t		sd;
+		std::vector<uint32_t>	col;
+		long			at = m_fp ? ftell( m_fp ) : -1;
+
+		if ( !m_fp || m_failed || at == m_end ) return false;
+		if ( m_end - at < (long)( sizeof( h ) + sizeof( sd ))) return corrupt( at, "truncated block header" );
+		if ( fread( h, sizeof( h ), 1, m_fp ) != 1 || fread( &sd, sizeof( sd ), 1, m_fp ) != 1 ) return corrupt( at, "read error" );
+
+		// the header is bounded by the rest of the file before the allocation
+		uint64_t	need = (uint64_t) h[ 0 ] * m_columns * sizeof( uint32_t );
+
+		if ( h[ 0 ] == 0 || h[ 1 ] != 0 ) return corrupt( at, "bad block header" );
+		if ( (uint64_t)( m_end - ftell( m_fp )) < need ) return corrupt( at, "truncated block" );
+
+		seed = sd;
+		r.assign( h[ 0 ], trial_record());
+		col.resize( h[ 0 ] );
+		for ( unsigned k = 0; k < m_columns; ++k ) {
+			if ( fread( col.data(), sizeof( uint32_t ), col.size(), m_fp ) != col.size()) return corrupt( at, "read error" );
+			if ( k < trial_record::Columns ) {
+				for ( size_t i = 0; i < r.size(); ++i ) r[ i ].*trial_record::column( k ) = col[ i ];
+			}
+		}
+		return true;
+	}
+
+    private:
+	bool corrupt( long at, const char* what )
+	{
+		fprintf( stderr, "Error: %s: %s at offset %ld\n", m_path.c_str(), what, at );
+		m_failed = true;
+
+		return false;
+	}
+	bool read_header( FILE* fp )
+	{
+		char		magic[ 8 ];
+		char		name[ NameLength ];
+		uint32_t	n;
+
+		if ( fread( magic, 1, 8, fp ) != 8 || memcmp( magic, Magic, 8 ) != 0 ) return false;
+		if ( fread( &n, sizeof( n ), 1, fp ) != 1 ) return false;
+		for ( unsigned k = 0; k < n; ++k ) {
+			if ( fread( name, 1, NameLength, fp ) != NameLength ) return false;
+		}
+		m_columns = n;
+
+		return trial_record::Columns <= n;
+	}
+};
+
+const char*	record_file::Magic = "ACNHREC1";
+
 // Simulator Base
 // -----------------------------------------------------------------------------
 class simulator
@@ -1999,9 +3823,75 @@ class simulator
 
 	const unsigned		m_maxsteps;
 
+	std::vector<field_streams>	m_rng;	// of the fields in m_list, reseeded for each trial by ( m_seed, trial number, field id )
+	unsigned long long	m_seed;
+	unsigned		m_first;	// the first trial number
+	double			m_ci;		// target half-width of the adaptive regression, 0 for n trials
+	const char*		m_record;	// file of the trial records, or nullptr
+	const char*		m_checkpoint;	// checkpoint file of the regression, or nullptr
+	bool			m_resume;
+	const char*		m_tracepath;	// event trace of simulate(), or nullptr
+	trace_file*		m_trace;
+	trace_text		m_text;		// ff_base::is_verbose()
+	trace_sink*		m_user;		// set_sink()
+	trace_tee		m_sinks;	// bound to the fields by start_trial()
+
+	// time of the phases of step() by the fields in m_list, with --profile
+	enum { Harvest, Plant, Hydrate, Refresh, Phases };
+
+	struct field_profile
+	{
+		unsigned long long	ns[ Phases ];
+
+		field_profile() : ns() { }
+		unsigned long long total() const { return ns[ Harvest ] + ns[ Plant ] + ns[ Hydrate ] + ns[ Refresh ]; }
+	};
+	bool				m_profile;
+	std::vector<field_profile>	m_prof;
+	unsigned long long		m_profSteps;
+
+	step_stat			m_total;	// of the last regression()
+
+	// results of a chunk of the regression, the trials are run by sim ( a clone of this )
+	// and its results are merged into this in the order of chunks.
+	struct reg_chunk
+	{
+		unsigned			c;
+		step_stat			st;
+		std::vector<trial_record>	rec;
+		simulator*			sim;
+
+		reg_chunk( unsigned c, unsigned maxsteps ) : c( c ), st( maxsteps ), sim( nullptr ) { }
+		~reg_chunk() { delete sim; }
+	};
+
+	// state of a regression shared by the worker threads
+	struct reg_state
+	{
+		unsigned				n;		// trials to run
+		std::atomic<unsigned>			next;		// next chunk to run
+		std::atomic<unsigned>			limit;		// trials to merge
+		std::mutex				mtx;
+		step_stat				total;
+		pctl::plist<reg_chunk*, pctl::pStore>	done;		// chunks waiting for the merge
+		record_file				out;
+		std::chrono::steady_clock::time_point	saved;		// last checkpoint
+
+		reg_state( unsigned n, unsigned maxsteps )
+			: n( n ), next( 0 ), limit( n ), total( maxsteps ), saved( std::chrono::steady_clock::now()) { }
+	};
+	static std::atomic<bool>	s_interrupted;		// SIGINT during a regression with the checkpoint
+
+	static const unsigned	TrialsPerChunk = 100;		// unit of the work and the progress report
+	static const unsigned	AdaptiveMinTrials = 1000;	// before the half-width is trusted
+	static const unsigned	AdaptiveMaxTrials = 10000000;
+	static const unsigned	AdaptiveReport = 10000;		// progress report interval of the adaptive regression
+	static const unsigned	CheckpointInterval = 60;	// seconds
+
     public:
 	simulator( const unsigned maxsteps = DefaultMaxSteps )
-		: m_step( 0 ), m_visitor( 0 ), m_maxsteps( maxsteps )
+		: m_step( 0 ), m_visitor( 0 ), m_maxsteps( maxsteps ), m_seed( random_seed()), m_first( 0 ), m_ci( 0.0 ), m_record( nullptr ), m_checkpoint( nullptr ), m_resume( false ),
+		  m_tracepath( nullptr ), m_trace( nullptr ), m_user( nullptr ), m_profile( false ), m_profSteps( 0 ), m_total( maxsteps )
 	{ }
 	virtual ~simulator() { }
 
@@ -2009,7 +3899,8 @@ class simulator
 	virtual bool terminate_sim() = 0;
 	virtual bool terminate_reg() = 0;
 	unsigned simulate();
-	void regression( const unsigned n = 1000 );
+	unsigned regression( const unsigned n = 1000, const unsigned jobs = 1 );
+	const step_stat& total() const { return m_total; }		// steps of the last regression()
 	virtual void finalize() { }
 	
 	void step();
@@ -2017,11 +3908,145 @@ class simulator
 	virtual void stat() const { }
 
 	void set_visitor( unsigned char n ) { m_visitor = n; }
+	void set_options( const sim_options& o ) { m_seed = o.seed; m_first = o.trial; m_ci = o.ci; m_record = o.record;
+						  m_checkpoint = o.checkpoint; m_resume = o.resume; m_tracepath = o.trace; m_profile = o.profile;
+						  if ( o.verbose ) ff_base::verbose( true ); }
+	unsigned long long seed() const { return m_seed; }
+
+	// parallel regression I/F
+	//   clone() returns a new independent instance constructed with the same parameters,
+	//   or nullptr if the simulator cannot be run in parallel, then regression() runs one job.
+	//   merge() accumulates the results of the worker instance into this.
+	//   save() and load() write and read the accumulated results for the checkpoint.
+	virtual simulator* clone() const { return nullptr; }
+	virtual void merge( const simulator& s ) { }
+	virtual bool save( FILE* fp ) const { return true; }
+	virtual bool load( FILE* fp ) { return true; }
+
+	// one regression trial by the random numbers of ( m_seed, t ), returns its steps
+	unsigned trial( unsigned t, trial_record* r = nullptr );
+
+	// the regression trial t with the event trace to path
+	unsigned trace_trial( unsigned t, const char* path );
+
+	// a sink of the events in addition to --trace and --verbose, nullptr to remove
+	void set_sink( trace_sink* p ) { m_user = p; }
+
+	// the hot-path counters of the fields ( ACNH_COUNTERS ) and the profile ( --profile )
+	void print_counters( FILE* fp = stdout ) const;
+	void print_profile( FILE* fp = stdout ) const;
+
+	// fill the method specific columns of the record at the end of a regression trial
+	virtual void record( trial_record& r ) const { }
+
+	// snapshot I/F
+	//   save_state() writes the state of the running trial: step, random numbers and fields,
+	//   load_state() restores it into an instance of the same class. the simulators with their
+	//   own state of the trial override them and call the base.
+	//   fork() runs n continuations from the snapshot until terminate_reg(), the continuation k
+	//   is driven by the random numbers of ( m_seed, ForkStream + k ).
+	virtual void save_state( snapshot& s ) const;
+	virtual void load_state( snapshot& s );
+	bool take_snapshot( unsigned t, unsigned day, snapshot& s );
+	void fork( const snapshot& s, unsigned n, unsigned jobs, step_stat& st );
+	void branch( unsigned day, unsigned n, unsigned jobs );
+
+	static const unsigned long long	ForkStream = 1ull << 32;	// beyond the trial numbers
+
+    private:
+	void seed_streams( unsigned long long t );
+	void start_trial( unsigned t );
+	bool open_trace( const char* path, unsigned t );
+	void close_trace();
+	unsigned run_trial( unsigned t, trial_record* rec );
+	void regression_worker( reg_state* rs, bool parallel );
+	void merge_chunks( reg_state* rs );
+	void merge_counters( const simulator& s );
+	void profiled_step();
+	bool save_checkpoint( reg_state* rs ) const;
+	bool load_checkpoint( reg_state* rs, long* records );
 };
 
-unsigned simulator::simulate()
+std::atomic<bool>	simulator::s_interrupted( false );
+
+void simulator::start_trial( unsigned t )
 {
+	unsigned	id = 0;
+
+	m_sinks.clear();
+	if ( trace_policy::enabled ) {
+		m_sinks.add( m_trace );
+		if ( ff_base::is_verbose()) m_sinks.add( &m_text );
+		m_sinks.add( m_user );
+	}
+
+	seed_streams( t );
+	for ( ff_base* p : m_list ) p->bind( m_sinks.sink(), id++ );
+
 	initialize();
+}
+
+void simulator::seed_streams( unsigned long long t )
+{
+	// the fields of the same stage in two methods get the same streams, the fields of the same
+	// label in a method are told apart by the order
+	std::vector<unsigned>	ids;
+
+	m_rng.resize( m_list.size());
+	for ( ff_base* p : m_list ) {
+		unsigned	id = p->stream_id();
+
+		id += std::count( ids.begin(), ids.end(), id );
+		m_rng[ ids.size()].seed( m_seed, t, id );
+		p->bind( &m_rng[ ids.size()] );
+		ids.push_back( p->stream_id());
+	}
+}
+
+bool simulator::open_trace( const char* path, unsigned t )
+{
+	std::vector<std::string>	names;
+
+	if ( !trace_policy::enabled ) {
+		fprintf( stderr, "Error: built with ACNH_TRACE=0, no events are traced\n" );
+		return false;
+	}
+	for ( ff_base* p : m_list ) names.push_back( p->name());
+
+	m_trace = new trace_file();
+	if ( !m_trace->create( path, m_seed, t, names )) {
+		close_trace();
+		return false;
+	}
+	return true;
+}
+
+void simulator::close_trace()
+{
+	delete m_trace;
+	m_trace = nullptr;
+	for ( ff_base* p : m_list ) p->bind( nullptr, trace_event::None );
+	m_sinks.clear();
+}
+
+unsigned simulator::trace_trial( unsigned t, const char* path )
+{
+	if ( !open_trace( path, t )) exit( 1 );
+
+	unsigned	r = trial( t );
+
+	close_trace();
+
+	return r;
+}
+
+unsigned simulator::simulate()
+{
+	fprintf( stderr, "Info: seed %llu, trial %u\n", m_seed, m_first );
+
+	if ( m_tracepath && !open_trace( m_tracepath, m_first )) exit( 1 );
+
+	start_trial( m_first );
 
 	m_step = 0;
 	do {
@@ -2035,63 +4060,481 @@ unsigned simulator::simulate()
 	while ( !terminate_sim() );
 
 	finalize();
+	if ( m_trace ) close_trace();
+	print_counters( stderr );
+	print_profile( stderr );
 
 	return m_step;
 }
 
-void simulator::regression( const unsigned n )
+unsigned simulator::trial( unsigned t, trial_record* rec )
+{
+	start_trial( t );
+
+	m_step = 0;
+
+	return run_trial( t, rec );
+}
+
+unsigned simulator::run_trial( unsigned t, trial_record* rec )
+{
+	// continue the trial from m_step until terminate_reg()
+
+	do {
+		if ( m_maxsteps < ++m_step ) {
+			fprintf( stderr, "Error: over %u steps\n", m_maxsteps );
+			exit( 1 );
+		}
+		step();
+	}
+	while ( !terminate_reg() ); 
+
+	finalize();
+
+	if ( m_maxsteps <= m_step ) {
+		fprintf( stderr, "*** Error: too many steps in regression\n" );
+		print();
+		exit( 1 );
+	}
+
+	unsigned	r = m_step;
+
+	if ( rec ) {
+		*rec = trial_record();
+		rec->trial = t;
+		rec->steps = r;
+		record( *rec );
+	}
+	for ( ff_base* p : m_list ) p->recycle();
+
+	return r;
+}
+
+void simulator::regression_worker( reg_state* rs, bool parallel )
 {
-	unsigned	min = m_maxsteps;
-	unsigned	max = 0;
-	unsigned	sum = 0;
-	unsigned	sqs = 0;
+	// the trials of each chunk are run by a new clone when the regression is parallel or saved,
+	// then all the results are merged in the order of chunk number, and the progress report
+	// and the checkpoints do not depend on the thread scheduling.
+	// the adaptive regression stops at the first chunk where the half-width reaches m_ci,
+	// the chunks in flight at that time are not merged.
+
+	unsigned	c;
 
-	for ( unsigned i = 0; i < n; ++i ) {
+	while (( c = rs->next.fetch_add( 1 )) * TrialsPerChunk < rs->limit.load()) {
 
-		initialize();
+		reg_chunk*	ch = new reg_chunk( c, m_maxsteps );
+		simulator*	s  = this;
+		unsigned	e  = ( c + 1 ) * TrialsPerChunk;
+		trial_record	r;
 
-		m_step = 0;
-		do {
-			if ( m_maxsteps < ++m_step ) {
-				fprintf( stderr, "Error: over %u steps\n", m_maxsteps );
-				exit( 1 );
+		if ( parallel && ( ch->sim = clone())) {
+			s = ch->sim;
+			s->set_visitor( m_visitor );
+			s->m_seed  = m_seed;
+			s->m_first = m_first;
+			s->m_profile = m_profile;
+		}
+		for ( unsigned i = c * TrialsPerChunk; i < rs->n && i < e; ++i ) {
+			if ( m_record ) {
+				ch->st.add( s->trial( m_first + i, &r ));
+				ch->rec.push_back( r );
+			} else {
+				ch->st.add( s->trial( m_first + i ));
 			}
-			step();
 		}
-		while ( !terminate_reg() ); 
 
-		finalize();
+		std::lock_guard<std::mutex>	lock( rs->mtx );
 
-		if ( m_maxsteps <= m_step ) {
-			fprintf( stderr, "*** Error: too many steps in regression\n" );
-			print();
-			exit( 1 );
+		rs->done.push_back( ch );
+		merge_chunks( rs );
+	}
+}
+
+void simulator::merge_chunks( reg_state* rs )
+{
+	step_stat*	total = &rs->total;
+
+	for ( bool found = true; found; ) {
+		found = false;
+		for ( auto i = rs->done.begin(); i != rs->done.end(); ++i ) {
+			if ( (*i)->c * TrialsPerChunk == total->count() && total->count() < rs->limit.load()) {
+				total->merge( (*i)->st );
+				if ( (*i)->sim ) {
+					merge( *(*i)->sim );
+					merge_counters( *(*i)->sim );
+				}
+				if ( m_record ) rs->out.write( m_seed, (*i)->rec );
+				rs->done.erase( i );
+				found = true;
+
+				if ( 0.0 < m_ci ) {
+					double	hw = total->half_width();
+
+					if ( AdaptiveMinTrials <= total->count() && hw <= m_ci ) {
+						rs->limit.store( total->count());
+					} else if ( total->count() % AdaptiveReport == 0 ) {
+						printf( "%u traials, min = %u, max = %u, average = %f +- %f\n",
+							total->count(), total->min(), total->max(), total->mean(), hw );
+					}
+				} else if ( total->count() < rs->n ) {
+					printf( "%u traials, min = %u, max = %u, average = %f\n",
+						total->count(), total->min(), total->max(), total->mean());
+				}
+
+				if ( m_checkpoint ) {
+					if ( s_interrupted.load()) {
+						rs->limit.store( total->count());
+					} else if ( std::chrono::steady_clock::now() - rs->saved >= std::chrono::seconds( unsigned( CheckpointInterval ))) {
+						save_checkpoint( rs );
+						rs->saved = std::chrono::steady_clock::now();
+					}
+				}
+				break;
+			}
+		}
+	}
+}
+
+// checkpoint file:
+//	"ACNHCKP1", seed ( u64 ), first, trials, maxsteps, visitor, merged trials ( u32 ), ci ( double ),
+//	size of the record file ( i64, -1 if none ), step_stat, results of the simulator ( save())
+bool simulator::save_checkpoint( reg_state* rs ) const
+{
+	std::string	tmp = std::string( m_checkpoint ) + ".tmp";
+	FILE*		fp = fopen( tmp.c_str(), "wb" );
+	uint64_t	sd = m_seed;
+	uint32_t	h[ 5 ] = { m_first, rs->n, m_maxsteps, m_visitor, rs->total.count() };
+	int64_t		rc = m_record ? rs->out.size() : -1;
+	bool		ok;
+
+	if ( !fp ) {
+		fprintf( stderr, "Warning: cannot save the checkpoint %s\n", tmp.c_str());
+		return false;
+	}
+	ok = fwrite( "ACNHCKP1", 1, 8, fp ) == 8 &&
+	     fwrite( &sd, sizeof( sd ), 1, fp ) == 1 && fwrite( h, sizeof( h ), 1, fp ) == 1 &&
+	     fwrite( &m_ci, sizeof( m_ci ), 1, fp ) == 1 && fwrite( &rc, sizeof( rc ), 1, fp ) == 1 &&
+	     rs->total.save( fp ) && save( fp );
+	ok = ( fclose( fp ) == 0 ) && ok && rename( tmp.c_str(), m_checkpoint ) == 0;
+
+	if ( !ok ) fprintf( stderr, "Warning: cannot save the checkpoint %s\n", m_checkpoint );
+
+	return ok;
+}
+
+bool simulator::load_checkpoint( reg_state* rs, long* records )
+{
+	FILE*		fp = fopen( m_checkpoint, "rb" );
+	char		magic[ 8 ];
+	uint64_t	sd;
+	uint32_t	h[ 5 ];
+	double		ci;
+	int64_t		rc;
+
+	if ( !fp ) {
+		fprintf( stderr, "Error: cannot open the checkpoint %s\n", m_checkpoint );
+		return false;
+	}
+
+	bool	ok = fread( magic, 1, 8, fp ) == 8 && memcmp( magic, "ACNHCKP1", 8 ) == 0 &&
+		     fread( &sd, sizeof( sd ), 1, fp ) == 1 && fread( h, sizeof( h ), 1, fp ) == 1 &&
+		     fread( &ci, sizeof( ci ), 1, fp ) == 1 && fread( &rc, sizeof( rc ), 1, fp ) == 1;
+
+	if ( ok && ( h[ 0 ] != m_first || h[ 1 ] != rs->n || h[ 2 ] != m_maxsteps || h[ 3 ] != m_visitor || ci != m_ci )) {
+		fprintf( stderr, "Error: the checkpoint %s is of the other regression\n", m_checkpoint );
+		fclose( fp );
+		return false;
+	}
+	ok = ok && rs->total.load( fp ) && load( fp ) && rs->total.count() == h[ 4 ];
+	fclose( fp );
+
+	if ( !ok ) {
+		fprintf( stderr, "Error: broken checkpoint %s\n", m_checkpoint );
+		return false;
+	}
+	m_seed   = sd;
+	*records = rc;
+	rs->next.store( h[ 4 ] / TrialsPerChunk );
+
+	return true;
+}
+
+unsigned simulator::regression( const unsigned trials, const unsigned jobs )
+{
+	// with m_ci, trials are drawn in chunks until the half-width of the average reaches it,
+	// and the number of the trials used is returned.
+	reg_state	rs(( 0.0 < m_ci ) ? AdaptiveMaxTrials : trials, m_maxsteps );
+	const unsigned	n = rs.n;
+	long		records = -1;
+
+	unsigned	nj = ( jobs == 0 ) ? std::thread::hardware_concurrency() : jobs;
+	unsigned	nc = ( n + TrialsPerChunk - 1 ) / TrialsPerChunk;
+	bool		vb = ff_base::is_verbose();
+
+	if ( nc < nj ) nj = nc;
+	if ( 1 < nj && !std::unique_ptr<simulator>( clone())) {
+		// the trials of a simulator without clone() share this, they are run by one thread
+		fprintf( stderr, "Info: %u jobs requested, the simulator is not clonable, 1 job\n", nj );
+		nj = 1;
+	}
+
+	// clones by chunk for the jobs or the checkpoint, this if clone() returns nullptr
+	bool		parallel = ( 1 < nj || m_checkpoint );
+	if ( m_checkpoint && m_resume && !load_checkpoint( &rs, &records )) exit( 1 );
+	if ( m_record && !rs.out.append( m_record, records )) exit( 1 );
+	if ( m_checkpoint ) {
+		s_interrupted = false;
+		signal( SIGINT, []( int ) { s_interrupted = true; } );
+	}
+
+	if ( 0.0 < m_ci ) fprintf( stderr, "Info: seed %llu, trials %u.. until +-%g at 95%%\n", m_seed, m_first, m_ci );
+	else		  fprintf( stderr, "Info: seed %llu, trials %u..%u\n", m_seed, m_first, m_first + n - 1 );
+	if ( 0 < rs.total.count()) fprintf( stderr, "Info: resumed from trial %u\n", m_first + rs.total.count());
+
+	// each worker thread runs the chunks by its own simulators and flowers
+	std::vector<std::thread>	threads;
+
+	for ( unsigned j = 1; j < nj; ++j ) {
+		threads.emplace_back( [=, &rs]() {
+			ff_base::verbose( vb );
+			regression_worker( &rs, parallel );
+		});
+	}
+	regression_worker( &rs, parallel );
+
+	for ( std::thread& t : threads ) t.join();
+
+	if ( m_checkpoint ) {
+		signal( SIGINT, SIG_DFL );
+		save_checkpoint( &rs );
+		if ( s_interrupted.load()) {
+			fprintf( stderr, "Info: interrupted, %u traials saved to %s ( --resume to continue )\n",
+				 rs.total.count(), m_checkpoint );
+			exit( 130 );
+		}
+	}
+
+	const step_stat&	total = rs.total;
+
+	printf( "%u traials, ", total.count());
+	total.print( "" );
+
+	if ( 0.0 < m_ci ) {
+		if ( total.half_width() <= m_ci ) {
+			printf( "95%% confidence interval: %f +- %f in %u traials\n", total.mean(), total.half_width(), total.count());
+		} else {
+			fprintf( stderr, "Warning: +-%f at 95%% after %u traials, not reached +-%g\n", total.half_width(), total.count(), m_ci );
+		}
+	}
+	print_counters();
+	print_profile();
+	m_total = total;
+
+	return total.count();
+}
+
+void simulator::merge_counters( const simulator& s )
+{
+	// s is a clone of this, then the fields are in the same order
+	auto	j = s.m_list.begin();
+
+	for ( auto i = m_list.begin(); i != m_list.end() && j != s.m_list.end(); ++i, ++j ) (*i)->merge_counters( **j );
+
+	if ( m_prof.size() < s.m_prof.size()) m_prof.resize( s.m_prof.size());
+	for ( unsigned i = 0; i < s.m_prof.size(); ++i ) {
+		for ( unsigned k = 0; k < Phases; ++k ) m_prof[ i ].ns[ k ] += s.m_prof[ i ].ns[ k ];
+	}
+	m_profSteps += s.m_profSteps;
+}
+
+void simulator::print_counters( FILE* fp ) const
+{
+	if ( !field_counters::enabled ) return;
+
+	fprintf( fp, "%-32s", "counters" );
+	for ( unsigned k = 0; k < counter_kind::Counters; ++k ) fprintf( fp, " %11s", counter_kind::name( k ));
+	fprintf( fp, "\n" );
+	for ( const ff_base* p : m_list ) {
+		fprintf( fp, "%-32s", p->name());
+		for ( unsigned k = 0; k < counter_kind::Counters; ++k ) fprintf( fp, " %11llu", p->counters().get( k ));
+		fprintf( fp, "\n" );
+	}
+}
+
+void simulator::print_profile( FILE* fp ) const
+{
+	// the fields of the same name are summed, ranked by the total time
+	std::vector<std::pair<std::string, field_profile>>	r;
+	unsigned long long					all = 0;
+	unsigned						i = 0;
+
+	if ( !m_profile || m_prof.empty()) return;
+
+	for ( const ff_base* p : m_list ) {
+		auto	q = std::find_if( r.begin(), r.end(), [p]( const std::pair<std::string, field_profile>& e ) { return e.first == p->name(); } );
+
+		if ( q == r.end()) q = r.insert( r.end(), { p->name(), field_profile() } );
+		for ( unsigned k = 0; k < Phases; ++k ) q->second.ns[ k ] += m_prof[ i ].ns[ k ];
+		all += m_prof[ i++ ].total();
+	}
+	std::stable_sort( r.begin(), r.end(), []( const std::pair<std::string, field_profile>& a, const std::pair<std::string, field_profile>& b ) {
+		return a.second.total() > b.second.total();
+	});
+
+	char	head[ 64 ];
+
+	snprintf( head, sizeof( head ), "profile ( %llu steps, ms )", m_profSteps );
+	fprintf( fp, "%-32s %10s %10s %10s %10s %10s\n", head, "harvest", "plant", "hydrate", "refresh", "total" );
+	for ( const auto& e : r ) {
+		fprintf( fp, "%-32s", e.first.c_str());
+		for ( unsigned k = 0; k < Phases; ++k ) fprintf( fp, " %10.2f", e.second.ns[ k ] / 1e6 );
+		fprintf( fp, " %10.2f %5.1f%%\n", e.second.total() / 1e6, ( 0 < all ) ? 100.0 * e.second.total() / all : 0.0 );
+	}
+}
+
+void simulator::save_state( snapshot& s ) const
+{
+	s.put( m_step );
+	s.put( m_visitor );
+	for ( const field_streams& r : m_rng ) s.put( r );
+	for ( ff_base* p : m_list ) p->save_state( s );
+}
+
+void simulator::load_state( snapshot& s )
+{
+	s.get( m_step );
+	s.get( m_visitor );
+	unsigned	id = 0;
+
+	m_rng.resize( m_list.size());
+	for ( field_streams& r : m_rng ) s.get( r );
+	for ( ff_base* p : m_list ) {
+		p->bind( &m_rng[ id++ ] );
+		p->load_state( s );
+	}
+}
+
+bool simulator::take_snapshot( unsigned t, unsigned day, snapshot& s )
+{
+	// the state of the trial t after the step of the day, false if the trial ends before
+	bool	r = true;
+
+	start_trial( t );
+
+	for ( m_step = 0; m_step < day; ) {
+		++m_step;
+		step();
+		if ( terminate_reg()) {
+			r = false;
+			break;
 		}
+	}
+	if ( r ) {
+		s.clear();
+		save_state( s );
+	}
+	finalize();
+	for ( ff_base* p : m_list ) p->recycle();
+
+	return r;
+}
 
-		// stat
-		if ( m_step < min ) min = m_step;
-		if ( max < m_step ) max = m_step;
-		sum += m_step;
-		sqs += m_step * m_step;
+void simulator::fork( const snapshot& s, unsigned n, unsigned jobs, step_stat& st )
+{
+	// the steps of the continuations are gathered by index, then st does not depend on jobs
+	std::vector<unsigned>		steps( n );
+	std::atomic<unsigned>		next( 0 );
+	std::vector<std::thread>	threads;
+	bool				vb = ff_base::is_verbose();
+
+	if ( jobs == 0 ) jobs = std::thread::hardware_concurrency();
+	if ( n < jobs ) jobs = n;
+
+	for ( unsigned j = 0; j < jobs; ++j ) {
+		threads.emplace_back( [&, vb]() {
+			simulator*	w = clone();
+
+			if ( !w ) return;
+			ff_base::verbose( vb );
+			w->m_seed = m_seed;
+			for ( unsigned k; ( k = next.fetch_add( 1 )) < n; ) {
+				snapshot	c = s;
+
+				c.rewind();
+				w->load_state( c );
+				w->seed_streams( ForkStream + k );
+				steps[ k ] = w->run_trial( k, nullptr );
+			}
+			delete w;
+		});
+	}
+	for ( std::thread& t : threads ) t.join();
 
-		if ( i != 0 && i % 100 == 0 )
-			printf( "%u traials, min = %u, max = %u, average = %f\n", i, min, max, 1.0 * sum / i );
+	if ( next.load() < n ) {
+		// not clonable, continue in this
+		for ( unsigned k = 0; k < n; ++k ) {
+			snapshot	c = s;
 
-		for ( ff_base* p : m_list ) p->recycle();
-		flower::clear_pool();
+			c.rewind();
+			load_state( c );
+			seed_streams( ForkStream + k );
+			steps[ k ] = run_trial( k, nullptr );
+		}
 	}
+	for ( unsigned k = 0; k < n; ++k ) st.add( steps[ k ] );
+}
+
+void simulator::branch( unsigned day, unsigned n, unsigned jobs )
+{
+	snapshot	s;
+	step_stat	st( m_maxsteps );
 
-	double	avg = 1.0 * sum / n;
-	double	sigma = sqrt( sqs / n - avg * avg );
+	fprintf( stderr, "Info: seed %llu, trial %u, %u continuations from the day %u\n", m_seed, m_first, n, day );
 
-	printf( "%u traials, min = %u, max = %u, average = %f, sigma = %f\n", n, min, max, avg, sigma );
+	if ( !take_snapshot( m_first, day, s )) {
+		fprintf( stderr, "Error: trial %u ends before the day %u\n", m_first, day );
+		exit( 1 );
+	}
+	fork( s, n, jobs, st );
+
+	printf( "%u continuations from the day %u ( snapshot %zu bytes ), ", n, day, s.size());
+	st.print( "" );
+	printf( "remaining steps: average = %f\n", st.mean() - day );
 }
 
 void simulator::step()
 {
+	if ( m_profile ) {
+		profiled_step();
+		return;
+	}
 	for ( ff_base* p : m_list ) p->harvest();
 	for ( ff_base* p : m_list ) p->plant();
 	for ( ff_base* p : m_list ) p->hydrate( m_visitor );
 	for ( ff_base* p : m_list ) p->daily_refresh();
 }
 
+void simulator::profiled_step()
+{
+	// the time stamps are chained, one clock read for each call
+	typedef std::chrono::steady_clock	clock;
+
+	unsigned		i;
+	clock::time_point	t = clock::now(), u;
+
+	if ( m_prof.size() < m_list.size()) m_prof.resize( m_list.size());
+
+	auto	lap = [&]( unsigned k ) {
+		u = clock::now();
+		m_prof[ i++ ].ns[ k ] += std::chrono::duration_cast<std::chrono::nanoseconds>( u - t ).count();
+		t = u;
+	};
+
+	i = 0; for ( ff_base* p : m_list ) { p->harvest(); lap( Harvest ); }
+	i = 0; for ( ff_base* p : m_list ) { p->plant(); lap( Plant ); }
+	i = 0; for ( ff_base* p : m_list ) { p->hydrate( m_visitor ); lap( Hydrate ); }
+	i = 0; for ( ff_base* p : m_list ) { p->daily_refresh(); lap( Refresh ); }
+	++m_profSteps;
+}
+
+#endif // ACNH_H
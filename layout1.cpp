@@ -8,11 +8,35 @@
 
 // Simulator of Flower Layout (White Rose(0010) -> Purple Rose(0020))
 // -----------------------------------------------------------------------------
-template <unsigned C>
-class ff_layout : public flower_field<5,C>
+
+// layouts of 5 rows by the pattern of 2 columns, repeated to the width of the field
+// ( and to the height by 5 rows for ff_dlayout )
+struct layout_pattern
+{
+	const char*	name;
+	const char*	cells[ 5 ];	// 'X': mature White Rose
+
+	bool is_set( unsigned r, unsigned c ) const { return cells[ r % 5 ][ c % 2 ] == 'X'; }
+};
+
+const layout_pattern	patterns[] = {
+	{ "layout   8", { "X.", "X.", "..", "X.", "X." }},
+	{ "layout   9", { "X.", "X.", ".X", "X.", "X." }},
+	{ "layout  10", { ".X", "XX", "X.", "XX", ".X" }},
+	{ "layout  11", { "XX", "X.", ".X", "X.", "XX" }},
+	{ "layout 12O", { "XX", "X.", "X.", "X.", "XX" }},
+	{ "layout 12H", { "X.", "XX", "X.", "XX", "X." }},
+	{ "layout  13", { "XX", "X.", "XX", "X.", "XX" }},
+	{ "layout  7X", { ".X", "X.", ".X", "X.", ".X" }},
+	{ "layout  8X", { "X.", ".X", "X.", ".X", "X." }},
+};
+
+// harvest and stats of a layout on flower_field<5,C> or ff_dynamic
+template <typename F>
+class layout_base : public F
 {
     protected:
-	typedef	flower_field<5,C>	super;
+	typedef	F			super;
 
 	unsigned			m_prods;
 	unsigned			m_clone;
@@ -21,26 +45,33 @@ class ff_layout : public flower_field<5,C>
 	unsigned			m_wh000;
 
     public:
-	ff_layout<C>( const char* n )
-		: flower_field<5,C>( n ),
+	template <typename... A>
+	layout_base( A... a )
+		: F( a... ),
 		  m_prods( 0 ), m_clone( 0 ), m_pu002( 0 ), m_wh001( 0 ), m_wh000( 0 )
 	{ }
-	~ff_layout<C>() { }
+	~layout_base() { }
 
 	void harvest() override
 	{
-		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) {
- 			flower*	f = super::pull( *i );
-
-			if ( f->get_gene() == 0xC0 ) ++m_pu002;
-			if ( f->get_gene() == 0x80 ) ++m_wh001;
-			if ( f->get_gene() == gWhRose ) ++m_wh001;
-			if ( f->get_gene() == 0x00 ) ++m_wh000;
-			if ( f->is_clone()) ++m_clone;
-			++m_prods; 
-		}
+		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) tally( super::pull( *i ));
+	}
+
+	// count a harvested flower ( also called by ff_lockstep )
+	void tally( const flower& f )
+	{
+		if ( f.get_gene() == 0xC0 ) ++m_pu002;
+		if ( f.get_gene() == 0x80 ) ++m_wh001;
+		if ( f.get_gene() == gWhRose ) ++m_wh001;
+		if ( f.get_gene() == 0x00 ) ++m_wh000;
+		if ( f.is_clone()) ++m_clone;
+		++m_prods; 
 	}
 
+	unsigned prods() const { return m_prods; }
+	unsigned clones() const { return m_clone; }
+	unsigned targets() const { return m_pu002; }
+
 	void stats()
 	{
 		printf( "%s: pu002/total=%u/%u, pu/wh1/wh0=(%.2f%%/%.2f%%/%.2f%%), %u(%.3f%%) clones\n",
@@ -55,157 +86,39 @@ class ff_layout : public flower_field<5,C>
 };
 
 template <unsigned C>
-class ff_layout8 : public ff_layout<C>
-{
-    public:
-	ff_layout8() : ff_layout<C>( "layout   8" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
-		}
-	}
-};
-
-template <unsigned C>
-class ff_layout9 : public ff_layout<C>
-{
-    public:
-	ff_layout9() : ff_layout<C>( "layout   9" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 2, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
-		}
-	}
-};
-
-template <unsigned C>
-class ff_layout10 : public ff_layout<C>
-{
-    public:
-	ff_layout10() : ff_layout<C>( "layout  10" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 0, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 1, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 2, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 3, c + 1 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 4, c + 1 } );
-		}
-	}
-};
-
-template <unsigned C>
-class ff_layout11 : public ff_layout<C>
-{
-    public:
-	ff_layout11() : ff_layout<C>( "layout  11" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 0, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 2 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 2, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 2 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 4, c + 1 } );
-		}
-	}
-};
-
-template <unsigned C>
-class ff_layout12O : public ff_layout<C>
-{
-    public:
-	ff_layout12O() : ff_layout<C>( "layout 12O" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 0, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 2, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 4, c + 1 } );
-		}
-	}
-};
-
-template <unsigned C>
-class ff_layout12H : public ff_layout<C>
+class ff_layout : public layout_base<flower_field<5,C>>
 {
     public:
-	ff_layout12H() : ff_layout<C>( "layout 12H" )
+	ff_layout<C>( const layout_pattern& p ) : layout_base<flower_field<5,C>>( p.name )
 	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 1, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 2, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 3, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
+		for ( unsigned r = 0; r < 5; ++r ) {
+			for ( unsigned c = 0; c < C; ++c ) {
+				if ( p.is_set( r, c )) this->set( rose::create( gWhRose, 3 ), { r, c } );
+			}
 		}
 	}
 };
 
-template <unsigned C>
-class ff_layout13 : public ff_layout<C>
-{
-    public:
-	ff_layout13() : ff_layout<C>( "layout  13" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 0, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 2, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 2, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 4, c + 1 } );
-		}
-	}
-};
+template <unsigned C> struct ff_layout8   : public ff_layout<C> { ff_layout8()   : ff_layout<C>( patterns[ 0 ] ) { } };
+template <unsigned C> struct ff_layout9   : public ff_layout<C> { ff_layout9()   : ff_layout<C>( patterns[ 1 ] ) { } };
+template <unsigned C> struct ff_layout10  : public ff_layout<C> { ff_layout10()  : ff_layout<C>( patterns[ 2 ] ) { } };
+template <unsigned C> struct ff_layout11  : public ff_layout<C> { ff_layout11()  : ff_layout<C>( patterns[ 3 ] ) { } };
+template <unsigned C> struct ff_layout12O : public ff_layout<C> { ff_layout12O() : ff_layout<C>( patterns[ 4 ] ) { } };
+template <unsigned C> struct ff_layout12H : public ff_layout<C> { ff_layout12H() : ff_layout<C>( patterns[ 5 ] ) { } };
+template <unsigned C> struct ff_layout13  : public ff_layout<C> { ff_layout13()  : ff_layout<C>( patterns[ 6 ] ) { } };
+template <unsigned C> struct ff_layout7X  : public ff_layout<C> { ff_layout7X()  : ff_layout<C>( patterns[ 7 ] ) { } };
+template <unsigned C> struct ff_layout8X  : public ff_layout<C> { ff_layout8X()  : ff_layout<C>( patterns[ 8 ] ) { } };
 
-template <unsigned C>
-class ff_layout7X : public ff_layout<C>
+// a layout of the rows and columns given at run time ( -r, -c )
+class ff_dlayout : public layout_base<ff_dynamic>
 {
     public:
-	ff_layout7X() : ff_layout<C>( "layout  7X" )
+	ff_dlayout( const layout_pattern& p, unsigned rows, unsigned cols ) : layout_base<ff_dynamic>( p.name, rows, cols )
 	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 0, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 1, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 2, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 3, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 4, c + 1 } );
-		}
-	}
-};
-
-template <unsigned C>
-class ff_layout8X : public ff_layout<C>
-{
-    public:
-	ff_layout8X() : ff_layout<C>( "layout  8X" )
-	{
-		for ( unsigned c = 0; c < C; c += 2 ) {
-			this->set( rose::create( gWhRose, 3 ), { 0, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 1, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 2, c + 0 } );
-			if ( c + 1 < C ) this->set( rose::create( gWhRose, 3 ), { 3, c + 1 } );
-			this->set( rose::create( gWhRose, 3 ), { 4, c + 0 } );
+		for ( unsigned r = 0; r < rows; ++r ) {
+			for ( unsigned c = 0; c < cols; ++c ) {
+				if ( p.is_set( r, c )) set( rose::create( gWhRose, 3 ), r, c );
+			}
 		}
 	}
 };
@@ -225,8 +138,10 @@ class LO_simulator : public simulator
 	ff_layout8X<C>		m_fX;
 
     public:
-	LO_simulator( const unsigned n = 1000 ) : simulator( n )
+	LO_simulator( const unsigned n = 1000, const sim_options& o = sim_options()) : simulator( n )
 	{
+		set_options( o );
+
 		m_list = { &m_f8, &m_f9, &m_fA, &m_fB, &m_fC, &m_fH, &m_fD, &m_fV, &m_fX };
 		for ( ff_base* f : m_list ) f->print();
 		fprintf( stderr, "\n" );
@@ -237,20 +152,40 @@ class LO_simulator : public simulator
 	bool terminate_reg() override { return true; }
 	void print() override { }
 
-	void stat( unsigned visitors )
+	template <unsigned L>
+	void lockstep()
+	{
+		// L trials of m_maxsteps steps from the trial m_first for each layout, in SIMD lanes
+		fprintf( stderr, "Info: seed %llu, trial %u..%u in lockstep\n", m_seed, m_first, m_first + L - 1 );
+
+		for ( ff_base* f : m_list ) {
+			if ( ff_layout<C>* p = dynamic_cast<ff_layout<C>*>( f )) {
+				ff_lockstep<5,C,L>	e( *p );
+
+				e.seed( m_seed, m_first );
+				e.run( m_maxsteps, m_visitor, *p );
+			}
+		}
+	}
+
+	void stat( unsigned visitors, unsigned lanes = 0 )
 	{
 		if ( 5 < visitors ) {
 			for ( unsigned v = 0; v <= 5; ++v ) {
 				printf( "visitors = %d, ", v );
-				stat( v );
+				stat( v, lanes );
 			}
 		} else {
 			set_visitor( visitors );
 		
 			if ( 0 < m_maxsteps ) {
-				simulate();
-		
-				printf( "%u steps for each Flower Layouts\n", m_maxsteps );
+				if      ( lanes == 8 )  lockstep<8>();
+				else if ( lanes == 16 ) lockstep<16>();
+				else if ( lanes == 32 ) lockstep<32>();
+				else			simulate();
+
+				if ( lanes ) printf( "%u steps x %u lanes for each Flower Layouts\n", m_maxsteps, lanes );
+				else	     printf( "%u steps for each Flower Layouts\n", m_maxsteps );
 				for ( ff_base* f : m_list ) {
 	       				if ( ff_layout<C>* p = dynamic_cast<ff_layout<C>*>( f )) p->stats();
 				}
@@ -267,17 +202,66 @@ typedef LO_simulator<7>		LO_simulator_2;
 typedef LO_simulator<11>	LO_simulator_3;
 typedef LO_simulator<15>	LO_simulator_4;
 
+// the layouts of the rows and columns given at run time, by ff_dynamic
+//	the same results as LO_simulator<C> for 5 rows, without its lockstep lanes
+// -----------------------------------------------------------------------------
+class LO_dsimulator : public simulator
+{
+	std::vector<std::unique_ptr<ff_dlayout>>	m_fields;
+
+    public:
+	LO_dsimulator( unsigned rows, unsigned cols, const unsigned n = 1000, const sim_options& o = sim_options()) : simulator( n )
+	{
+		set_options( o );
+
+		for ( const layout_pattern& p : patterns ) {
+			m_fields.emplace_back( new ff_dlayout( p, rows, cols ));
+			m_list.push_back( m_fields.back().get());
+		}
+		for ( ff_base* f : m_list ) f->print();
+		fprintf( stderr, "\n" );
+	}
+	~LO_dsimulator() { }
+
+	bool terminate_sim() override { return m_maxsteps <= m_step; }
+	bool terminate_reg() override { return true; }
+	void print() override { }
+
+	void stat( unsigned visitors )
+	{
+		if ( 5 < visitors ) {
+			for ( unsigned v = 0; v <= 5; ++v ) {
+				printf( "visitors = %d, ", v );
+				stat( v );
+			}
+		} else {
+			set_visitor( visitors );
+
+			if ( 0 < m_maxsteps ) {
+				simulate();
+
+				printf( "%u steps for each Flower Layouts\n", m_maxsteps );
+				for ( auto& p : m_fields ) p->stats();
+				printf( "\n" );
+			}
+		}
+	}
+};
+
+#ifndef ACNH_NO_MAIN
 //
 // main
 // 
 // -----------------------------------------------------------------------------
 int main( int argc, char** argv )
 {
-	std::srand( std::time(nullptr) );
-
+	sim_options	opt;
 	unsigned	visitor = 0;
 	unsigned	steps   = 1000;
 	unsigned	ff_unit = 0;
+	unsigned	lanes   = 0;
+	unsigned	rows    = 0;		// runtime-sized fields by -r / -c
+	unsigned	cols    = 0;
 	
 	for ( int i = 1; i < argc; ++i ) {
 		if ( *argv[ i ] == '-' ) {
@@ -289,19 +273,41 @@ int main( int argc, char** argv )
 				case 'w': ff_unit = 2; break;
 				case 't': ff_unit = 3; break;
 				case 'q': ff_unit = 4; break;
+				case 'l': lanes   = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'r': rows    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'c': cols    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
 				default:
-					fprintf( stderr, "Usage: %s [-a|-v visitors][-s steps][-h|-w|-t|-q]\n", argv[ 0 ] );
+					fprintf( stderr, "Usage: %s [-a|-v visitors][-s steps][-h|-w|-t|-q|-r rows -c cols][-l 8|16|32]%s\n", argv[ 0 ], sim_options::usage());
 					exit( 1 );
 			}
 		}
 	}
+	if ( lanes != 0 && lanes != 8 && lanes != 16 && lanes != 32 ) {
+		fprintf( stderr, "Usage: %s [-a|-v visitors][-s steps][-h|-w|-t|-q|-r rows -c cols][-l 8|16|32]%s\n", argv[ 0 ], sim_options::usage());
+		exit( 1 );
+	}
 
-	if      ( ff_unit == 1 ) LO_simulator_1h( steps ).stat( visitor );
-	else if ( ff_unit == 2 ) LO_simulator_2( steps ).stat( visitor );
-	else if ( ff_unit == 3 ) LO_simulator_3( steps ).stat( visitor );
-	else if ( ff_unit == 4 ) LO_simulator_4( steps ).stat( visitor );
-	else			 LO_simulator_1( steps ).stat( visitor );;
+	if ( rows || cols ) {
+		if ( rows == 0 ) rows = 5;
+		if ( cols == 0 ) cols = 3;
+		if ( 255 < rows || 255 < cols ) {
+			fprintf( stderr, "Error: %ux%u field, rows and columns are up to 255\n", rows, cols );
+			exit( 1 );
+		}
+		if ( lanes ) fprintf( stderr, "Warning: -l is for the compiled widths, ignored\n" );
+		LO_dsimulator( rows, cols, steps, opt ).stat( visitor );
+
+		return 0;
+	}
+
+	if      ( ff_unit == 1 ) LO_simulator_1h( steps, opt ).stat( visitor, lanes );
+	else if ( ff_unit == 2 ) LO_simulator_2( steps, opt ).stat( visitor, lanes );
+	else if ( ff_unit == 3 ) LO_simulator_3( steps, opt ).stat( visitor, lanes );
+	else if ( ff_unit == 4 ) LO_simulator_4( steps, opt ).stat( visitor, lanes );
+	else			 LO_simulator_1( steps, opt ).stat( visitor, lanes );;
 
 	return 0;
 }
-
+#endif // ACNH_NO_MAIN
@@ -37,21 +37,27 @@ class ff_layout : public flower_field<5,C>
 
 	void harvest() override
 	{
-		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) {
- 			flower*	f = super::pull( *i );
-
-			if ( flower::flower_no( f->get_gene()) == nOr121 ) ++m_or121;
-			if ( f->is_clone()) {
-				if ( f->get_gene() == gPu012 ) ++m_pu012;
-				if ( f->get_gene() == gOr110 ) ++m_or110;
-				++m_clone;
-			}
-			if ( f->is_color( Pu )) ++m_purple;
-			if ( f->is_color( Or )) ++m_orange;
-			++m_prods; 
+		for ( auto i = super::m_generation.begin(); i != super::m_generation.end(); ++i ) tally( super::pull( *i ));
+	}
+
+	// count a harvested flower ( also called by ff_lockstep )
+	void tally( const flower& f )
+	{
+		if ( flower::flower_no( f.get_gene()) == nOr121 ) ++m_or121;
+		if ( f.is_clone()) {
+			if ( f.get_gene() == gPu012 ) ++m_pu012;
+			if ( f.get_gene() == gOr110 ) ++m_or110;
+			++m_clone;
 		}
+		if ( f.is_color( Pu )) ++m_purple;
+		if ( f.is_color( Or )) ++m_orange;
+		++m_prods; 
 	}
 
+	unsigned prods() const { return m_prods; }
+	unsigned clones() const { return m_clone; }
+	unsigned targets() const { return m_or121; }
+
 	void stats() 
 	{
 		printf( "%s: or121/total = %u/%u(%.2f%%), clones:%u(%.3f%%) [or:%u/%u, pu:%u/%u]\n",
@@ -156,7 +162,7 @@ class LO_simulator : public simulator
 	ff_layout10<C>		m_fLR;
 
     public:
-	LO_simulator( const unsigned n = 1000 )
+	LO_simulator( const unsigned n = 1000, const sim_options& o = sim_options())
 		: simulator( n ),
 		  m_f7N( gOr110, gPu012 ), m_f7R( gPu012, gOr110 ),
 		  m_fXN( gOr110, gPu012 ), m_fXR( gPu012, gOr110 ),
@@ -164,6 +170,8 @@ class LO_simulator : public simulator
 		  m_f9N( gOr110, gPu012 ), m_f9R( gPu012, gOr110 ),
 		  m_fLN( gOr110, gPu012 ), m_fLR( gPu012, gOr110 )
 	{
+		set_options( o );
+
 		m_list = { &m_f7N, &m_f7R, &m_fXN, &m_fXR, &m_f8, &m_f9N, &m_f9R, &m_fLN, &m_fLR };
 		for ( ff_base* f : m_list ) f->print();
 	}
@@ -173,20 +181,40 @@ class LO_simulator : public simulator
 	bool terminate_reg() override { return true; }
 	void print() override { }
 
-	void stat( unsigned visitors )
+	template <unsigned L>
+	void lockstep()
+	{
+		// L trials of m_maxsteps steps from the trial m_first for each layout, in SIMD lanes
+		fprintf( stderr, "Info: seed %llu, trial %u..%u in lockstep\n", m_seed, m_first, m_first + L - 1 );
+
+		for ( ff_base* f : m_list ) {
+			if ( ff_layout<C>* p = dynamic_cast<ff_layout<C>*>( f )) {
+				ff_lockstep<5,C,L>	e( *p );
+
+				e.seed( m_seed, m_first );
+				e.run( m_maxsteps, m_visitor, *p );
+			}
+		}
+	}
+
+	void stat( unsigned visitors, unsigned lanes = 0 )
 	{
 		if ( 5 < visitors ) {
 			for ( unsigned v = 0; v <= 5; ++v ) {
 				printf( "visitors = %d, ", v );
-				stat( v );
+				stat( v, lanes );
 			}
 		} else {
 			set_visitor( visitors );
 
 			if ( 0 < m_maxsteps ) {
-				simulate();
+				if      ( lanes == 8 )  lockstep<8>();
+				else if ( lanes == 16 ) lockstep<16>();
+				else if ( lanes == 32 ) lockstep<32>();
+				else			simulate();
 
-				printf( "%u steps for each Flower Layouts\n", m_maxsteps );
+				if ( lanes ) printf( "%u steps x %u lanes for each Flower Layouts\n", m_maxsteps, lanes );
+				else	     printf( "%u steps for each Flower Layouts\n", m_maxsteps );
 				for ( ff_base* f : m_list ) {
 					if ( ff_layout<C>* p = dynamic_cast<ff_layout<C>*>( f )) p->stats();
 				}
@@ -203,17 +231,18 @@ typedef LO_simulator<7>		LO_simulator_2;
 typedef LO_simulator<11>	LO_simulator_3;
 typedef LO_simulator<15>	LO_simulator_4;
 
+#ifndef ACNH_NO_MAIN
 //
 // main
 // 
 // -----------------------------------------------------------------------------
 int main( int argc, char** argv )
 {
-	std::srand( std::time(nullptr) );
-
+	sim_options	opt;
 	unsigned	visitor = 0;
 	unsigned	steps   = 1000;
 	unsigned	ff_unit = 0;
+	unsigned	lanes   = 0;
 	
 	for ( int i = 1; i < argc; ++i ) {
 		if ( *argv[ i ] == '-' ) {
@@ -225,19 +254,26 @@ int main( int argc, char** argv )
 				case 'w': ff_unit = 2; break;
 				case 't': ff_unit = 3; break;
 				case 'q': ff_unit = 4; break;
+				case 'l': lanes   = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
 				default:
-					fprintf( stderr, "Usage: %s [-a|-v visitors][-s steps][-h|-w|-t|-q]\n", argv[ 0 ] );
+					fprintf( stderr, "Usage: %s [-a|-v visitors][-s steps][-h|-w|-t|-q][-l 8|16|32]%s\n", argv[ 0 ], sim_options::usage());
 					exit( 1 );
 			}
 		}
 	}
+	if ( lanes != 0 && lanes != 8 && lanes != 16 && lanes != 32 ) {
+		fprintf( stderr, "Usage: %s [-a|-v visitors][-s steps][-h|-w|-t|-q][-l 8|16|32]%s\n", argv[ 0 ], sim_options::usage());
+		exit( 1 );
+	}
 
-	if      ( ff_unit == 1 ) LO_simulator_1h( steps ).stat( visitor );
-	else if ( ff_unit == 2 ) LO_simulator_2( steps ).stat( visitor );
-	else if ( ff_unit == 3 ) LO_simulator_3( steps ).stat( visitor );
-	else if ( ff_unit == 4 ) LO_simulator_4( steps ).stat( visitor );
-	else		         LO_simulator_1( steps ).stat( visitor );
+	if      ( ff_unit == 1 ) LO_simulator_1h( steps, opt ).stat( visitor, lanes );
+	else if ( ff_unit == 2 ) LO_simulator_2( steps, opt ).stat( visitor, lanes );
+	else if ( ff_unit == 3 ) LO_simulator_3( steps, opt ).stat( visitor, lanes );
+	else if ( ff_unit == 4 ) LO_simulator_4( steps, opt ).stat( visitor, lanes );
+	else		         LO_simulator_1( steps, opt ).stat( visitor, lanes );
 
 	return 0;
 }
-
+#endif // ACNH_NO_MAIN
@@ -0,0 +1,55 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	the simulators of the methods in one program ( compare, replay )
+//
+
+#ifndef METHODS_H
+#define METHODS_H
+
+#include <acnh.h>
+
+#define ACNH_NO_MAIN
+
+namespace bn      {
+#include "bn.cpp"
+}
+namespace bn_lite {
+#include "bn_lite.cpp"
+}
+namespace ph      {
+#include "ph.cpp"
+}
+namespace gr      {
+#include "gr.cpp"
+}
+namespace grx     {
+#include "grx.cpp"
+}
+
+// methods
+// -----------------------------------------------------------------------------
+struct method
+{
+	const char*	name;
+	const char*	title;
+	simulator*	( *create )();
+};
+
+const method	methods[] = {
+	{ "bn",      "BackwardN Method",		[]() -> simulator* { return new bn::BN_simulator(); } },
+	{ "bn_lite", "BackwardN Method ( lite )",	[]() -> simulator* { return new bn_lite::BN_simulator(); } },
+	{ "ph",      "Paleh Method",			[]() -> simulator* { return new ph::PH_simulator(); } },
+	{ "gr",      "Guaranteed Hybrid Red Method",	[]() -> simulator* { return new gr::GR_simulator(); } },
+	{ "grx",     "Guaranteed Hybrid Red Method ( ext )", []() -> simulator* { return new grx::GR_simulator(); } },
+};
+
+const method* find_method( const char* name )
+{
+	for ( const method& m : methods ) {
+		if ( strcmp( m.name, name ) == 0 ) return &m;
+	}
+	return nullptr;
+}
+
+#endif // METHODS_H
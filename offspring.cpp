@@ -0,0 +1,102 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	exact offspring distribution of two flowers
+//
+
+#include <acnh.h>
+
+flowerType parse_species( char c )
+{
+	for ( unsigned t = Ro; t <= Tu; ++t ) {
+		if ( flowerTypeChar( static_cast<flowerType>( t )) == c ) return static_cast<flowerType>( t );
+	}
+	return Cv;
+}
+
+flower create( flowerType t, gene g )
+{
+	switch ( t ) {
+		case Ro: return rose::create( g );
+		case Hy: return hyacinth::create( g );
+		case Li: return lily::create( g );
+		case An: return anemone::create( g );
+		case Pa: return pansie::create( g );
+		case Co: return cosmos::create( g );
+		case Ch: return mum::create( g );
+		case Tu: return tulip::create( g );
+		default: return flower();
+	}
+}
+
+bool parse_gene( flowerType t, const char* s, gene& g )
+{
+	// Global notation "RYWS" (rose) / "RYW" (others) with the digits 0..2, or the raw gene "0x.."
+
+	static const unsigned	shift[ 4 ] = { 2, 4, 6, 0 };	// R, Y, W, S in Japanese local bit order
+	const unsigned		n = ( t == Ro ) ? 4 : 3;
+	const unsigned		base = ( t == Ro ) ? 0 : 2;
+
+	if ( s[ 0 ] == '0' && ( s[ 1 ] == 'x' || s[ 1 ] == 'X' )) {
+		g = strtoul( s, nullptr, 16 );
+		return true;
+	}
+	if ( strlen( s ) != n ) return false;
+
+	g = 0;
+	for ( unsigned i = 0; i < n; ++i ) {
+		if ( s[ i ] < '0' || '2' < s[ i ] ) return false;
+
+		unsigned d = s[ i ] - '0';
+		g |= (( d == 2 ) ? 3 : d ) << ( shift[ i ] - base );
+	}
+	return true;
+}
+
+//
+// main
+// 
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	flowerType	t = Ro;
+	const char*	p[ 2 ] = { nullptr, nullptr };
+	unsigned	np = 0;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 't': t = parse_species( *argv[ ++i ] ); break;
+				default:
+					t = Cv;
+			}
+		} else if ( np < 2 ) {
+			p[ np++ ] = argv[ i ];
+		}
+	}
+
+	gene	x, y;
+
+	if ( t == Cv || np < 2 || !parse_gene( t, p[ 0 ], x ) || !parse_gene( t, p[ 1 ], y )) {
+		fprintf( stderr, "Usage: %s [-t R|H|L|A|P|C|M|T] gene gene\n", argv[ 0 ] );
+		fprintf( stderr, "       gene: RYWS (rose) / RYW (others) with digits 0..2, or 0x.. in local bit order\n" );
+		return 1;
+	}
+
+	offspring_distribution	d = offspring( t, x, y );
+
+	create( t, x ).print( true, false, stdout );
+	printf( " x" );
+	create( t, y ).print( true, true, stdout );
+
+	printf( "colors:" );
+	d.print();
+
+	for ( unsigned k = 0; k < Genotypes; ++k ) {
+		if ( d.genotype[ k ] ) {
+			create( t, genotype_gene( k )).print( true, false, stdout );
+			printf( " %6.2f%%\n", 100.0 * d.genotype[ k ] / 256 );
+		}
+	}
+	return 0;
+}
@@ -84,22 +84,14 @@ class FP_simulator : public simulator
 	bool			m_regs;
 	bool			m_regp;
 
-	unsigned		m_smin;
-	unsigned		m_smax;
-	unsigned		m_ssum;
-	unsigned		m_ssqs;
-
-	unsigned		m_pmin;
-	unsigned		m_pmax;
-	unsigned		m_psum;
-	unsigned		m_psqs;
+	step_stat		m_solo;
+	step_stat		m_pair;
 
     public:
 	FP_simulator( const unsigned t, const unsigned maxsteps = DefaultMaxSteps )
 		: simulator( maxsteps ),
 		  m_target( t ), m_regs( true ), m_regp( true ),
-		  m_smin( maxsteps ), m_smax( 0 ), m_ssum( 0 ), m_ssqs( 0 ),
-		  m_pmin( maxsteps ), m_pmax( 0 ), m_psum( 0 ), m_psqs( 0 )
+		  m_solo( maxsteps ), m_pair( maxsteps )
 	{
 		m_list = { &m_s, &m_p };
 	}
@@ -122,24 +114,12 @@ class FP_simulator : public simulator
 	bool terminate_reg() override
 	{
 		if ( m_regs && m_target <= m_s.prods()) {
-
-			unsigned s1 = m_step - 1;
-
 			m_regs = false;
-			if ( m_step < m_smin ) m_smin = s1;
-			if ( m_smax < m_step ) m_smax = s1;
-			m_ssum += s1;
-			m_ssqs += s1 * s1;
+			m_solo.add( m_step - 1 );
 		}
 		if ( m_regp && m_target <= m_p.prods()) {
-
-			unsigned s1 = m_step - 1;
-
 			m_regp = false;
-			if ( s1 < m_pmin ) m_pmin = s1;
-			if ( m_pmax < s1 ) m_pmax = s1;
-			m_psum += s1;
-			m_psqs += s1 * s1;
+			m_pair.add( m_step - 1 );
 		}
 		if ( m_regs || m_regp ) {
 			return false;
@@ -152,30 +132,38 @@ class FP_simulator : public simulator
 	{
 		fprintf( stderr, "*** step %u ( solo/pair = %u/%u ) ***\n", m_step, m_s.prods(), m_p.prods());
 	}
-	void stat( unsigned r )
+	simulator* clone() const override { return new FP_simulator( m_target, m_maxsteps ); }
+	void merge( const simulator& s ) override
 	{
-		double	savg = 1.0 * m_ssum / r;
-		double	pavg = 1.0 * m_psum / r;
-		double	ssgm = sqrt( 1.0 * m_ssqs / r - savg * savg );
-		double	psgm = sqrt( 1.0 * m_psqs / r - pavg * pavg );
+		const FP_simulator&	t = static_cast<const FP_simulator&>( s );
 
-		printf( "  2 solo: min = %u, max = %u, average = %f, sigma = %f\n", m_smin, m_smax, savg, ssgm );
-		printf( "  1 pair: min = %u, max = %u, average = %f, sigma = %f\n", m_pmin, m_pmax, pavg, psgm );
+		m_solo.merge( t.m_solo );
+		m_pair.merge( t.m_pair );
+	}
+	bool save( FILE* fp ) const override { return m_solo.save( fp ) && m_pair.save( fp ); }
+	bool load( FILE* fp ) override { return m_solo.load( fp ) && m_pair.load( fp ); }
+	const step_stat& solo() const { return m_solo; }
+	const step_stat& pair() const { return m_pair; }
+	void stat() const override
+	{
+		m_solo.print( "  2 solo: " );
+		m_pair.print( "  1 pair: " );
 	}
 };
 
+#ifndef ACNH_NO_MAIN
 //
 // main
 // 
 // -----------------------------------------------------------------------------
 int main( int argc, char** argv )
 {
-	std::srand( std::time(nullptr) );
-
+	sim_options	opt;
 	unsigned	visitor = 0;
 	unsigned	targets = 100;
 	unsigned	repeats = 1000;
 	unsigned	maxstep = 1000;
+	unsigned	jobs    = 1;
 	bool		simulate = false;
 	
 	for ( int i = 1; i < argc; ++i ) {
@@ -185,8 +173,11 @@ int main( int argc, char** argv )
 				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
 				case 't': targets = strtoul( argv[ ++i ], nullptr, 0 ); break;
 				case 's': simulate = true; break;
+				case 'j': jobs    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
 				default:
-					fprintf( stderr, "Usage: %s [-v visitors][-t targets][-m maxstep][-s] [regressions]\n", argv[ 0 ] );
+					fprintf( stderr, "Usage: %s [-v visitors][-t targets][-m maxstep][-s][-j jobs] [regressions]%s\n", argv[ 0 ], sim_options::usage());
 					exit( 1 );
 			}
 		} else {
@@ -197,18 +188,19 @@ int main( int argc, char** argv )
 	FP_simulator	s( targets, maxstep );
 
 	s.set_visitor( visitor );
+	s.set_options( opt );
 
 	if ( simulate ) {
 		unsigned	n = s.simulate();
 
 		printf( "\n%u steps for %u flowers reproduction.\n", n, targets );
 	} else {
-		s.regression( repeats );
+		repeats = s.regression( repeats, jobs );
 
 		printf( "\nFlower Reproduction: %u regressions, target %u flower created.\n", repeats, targets );
-		s.stat( repeats );
+		s.stat();
 	}
 
 	return 0;
 }
-
+#endif // ACNH_NO_MAIN
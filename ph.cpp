@@ -74,9 +74,35 @@ class PH_simulator : public simulator
 	void finalize() override;
 	void print() override;
 
+	simulator* clone() const override { return new PH_simulator(); }
+	void merge( const simulator& s ) override
+	{
+		unsigned n = static_cast<const PH_simulator&>( s ).m_fmax;
+
+		if ( m_fmax < n ) m_fmax = n;
+	}
+	bool save( FILE* fp ) const override { return fwrite( &m_fmax, sizeof( m_fmax ), 1, fp ) == 1; }
+	bool load( FILE* fp ) override { return fread( &m_fmax, sizeof( m_fmax ), 1, fp ) == 1; }
+	void save_state( snapshot& s ) const override
+	{
+		simulator::save_state( s );
+		s.put( m_firstBlue );
+	}
+	void load_state( snapshot& s ) override
+	{
+		simulator::load_state( s );
+		s.get( m_firstBlue );
+	}
+
 	unsigned maxFieldUnits() const { return m_fmax; }
 	unsigned firstBlue() const { return m_firstBlue; }
 
+	void record( trial_record& r ) const override
+	{
+		r.first_blue  = ( m_fB.count() != 0 ) ? m_step : 0;
+		r.field_units = usingFields();		// the fields are counted at the end as finalize()
+	}
+
     private:
 	unsigned usingFields() const;
 };
@@ -165,16 +191,17 @@ void PH_simulator::print()
 	if ( m_fB.count() != 0 ) m_fB.print();
 }
 
+#ifndef ACNH_NO_MAIN
 //
 // main
 //
 // -----------------------------------------------------------------------------
 int main( int argc, char** argv )
 {
-	std::srand( std::time(nullptr) );
-
+	sim_options	opt;
 	unsigned	visitor = 0;
 	unsigned	repeats = 0;
+	unsigned	jobs    = 1;
 
 	for ( int i = 1; i < argc; ++i ) {
 		if ( *argv[ i ] == '-' ) {
@@ -182,8 +209,11 @@ int main( int argc, char** argv )
 				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
 				case 's':
 				case 'r': repeats = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'j': jobs    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
 				default:
-					fprintf( stderr, "Usage %s [-v visitors][-r repeats]\n", argv[ 0 ] );
+					fprintf( stderr, "Usage %s [-v visitors][-r repeats][-j jobs]%s\n", argv[ 0 ], sim_options::usage());
 					return -1;
 			}
 		}
@@ -192,17 +222,20 @@ int main( int argc, char** argv )
 	PH_simulator    s;
 
 	s.set_visitor( visitor );
+	s.set_options( opt );
 
-	if ( repeats == 0 ) {
+	if ( 0 < opt.forks ) {
+		s.branch( opt.fork_day, opt.forks, jobs );
+	} else if ( repeats == 0 && opt.ci == 0.0 ) {
 		unsigned	n = s.simulate();
 
 		printf( "\nPaleh Method: %u steps, maximum %u field units used.\n", n, s.maxFieldUnits());
 		printf( "       first blue rose in %u steps\n", s.firstBlue());
 	} else {
-		s.regression( repeats );
+		repeats = s.regression( repeats, jobs );
 		printf( "\nPaleh Method: %u regressions, maximum %u field units used.\n", repeats, s.maxFieldUnits());
 	}
 
 	return 0;
 }
-
+#endif // ACNH_NO_MAIN
@@ -0,0 +1,83 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	simulator of the methods defined by the pipeline files ( pipelines/*.pipe )
+//
+
+#include <acnh.h>
+
+#include "pipeline.h"
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	sim_options			opt;
+	unsigned			visitor = 0;
+	unsigned			repeats = 0;
+	unsigned			jobs    = 1;
+	std::vector<PL_simulator*>	sims;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 's':
+				case 'r': repeats = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'j': jobs    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
+				default:
+					fprintf( stderr, "Usage: %s [-v visitors][-r repeats][-j jobs]%s file ...\n", argv[ 0 ], sim_options::usage());
+					return -1;
+			}
+		} else if ( PL_simulator* s = PL_simulator::from_file( argv[ i ] )) {
+			sims.push_back( s );
+		} else {
+			return 1;
+		}
+	}
+	if ( sims.empty()) {
+		fprintf( stderr, "Usage: %s [-v visitors][-r repeats][-j jobs]%s file ...\n", argv[ 0 ], sim_options::usage());
+		return -1;
+	}
+
+	// one file runs as the sample simulators, the files of a batch run the same trials
+	for ( PL_simulator* s : sims ) {
+		s->set_visitor( visitor );
+		s->set_options( opt );
+		if ( 1 < sims.size()) printf( "\n%s ( %s ): ", s->title(), s->path());
+
+		if ( 0 < opt.forks ) {
+			s->branch( opt.fork_day, opt.forks, jobs );
+		} else if ( repeats == 0 && opt.ci == 0.0 && sims.size() == 1 ) {
+			unsigned	n = s->simulate();
+
+			printf( "\n%s: %u steps, maximum %u field units used.\n", s->title(), n, s->maxFieldUnits());
+			printf( "	first goal in %u steps\n", s->firstGoal());
+		} else {
+			s->regression(( repeats == 0 ) ? 1000 : repeats, jobs );
+			if ( sims.size() == 1 ) printf( "\n%s: maximum %u field units used.\n", s->title(), s->maxFieldUnits());
+		}
+	}
+
+	// ranking of the batch by the average steps
+	if ( 1 < sims.size() && opt.forks == 0 ) {
+		std::vector<PL_simulator*>	r( sims );
+
+		std::stable_sort( r.begin(), r.end(), []( const PL_simulator* a, const PL_simulator* b ) {
+			return a->total().mean() < b->total().mean();
+		});
+		printf( "\n%u pipelines, visitors = %u\n", (unsigned) r.size(), visitor );
+		printf( "  rank   average     sigma  units  method\n" );
+		for ( unsigned k = 0; k < r.size(); ++k ) {
+			printf( "  %4u %9.3f %9.3f %6u  %s ( %s )\n", k + 1, r[ k ]->total().mean(), r[ k ]->total().sigma(),
+				r[ k ]->maxFieldUnits(), r[ k ]->title(), r[ k ]->path());
+		}
+	}
+	for ( PL_simulator* s : sims ) delete s;
+
+	return 0;
+}
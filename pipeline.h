@@ -0,0 +1,533 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	simulators of the methods built at run time from the pipeline files ( pipeline, differ )
+//
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <acnh.h>
+#include <cctype>
+#include <cstdarg>
+#include <functional>
+
+// Pipeline file
+//	a method as text, one definition per line, '#' to the end of the line is a comment,
+//	a title with spaces is quoted. the fields are stepped in the order of their definitions,
+//	and the routes of a field are tried in the order of their definitions.
+//
+//	name "title"				title of the method
+//	field id kind units [c1 [c2]] ["title"]	a field, kind is the class without ff_:
+//						storage, isolated, selfHybrid, initialHybrid ( units 1..5 )
+//						pairHybrid, lineHybrid c1 c2 ( units 1..5 )
+//						swapHybrid ck ( units 2, 3, 6 ), hybridTest ( units 2..10, even )
+//	harvest id color to			define_harvest( color, to )
+//	test id color succ fail			define_test( color, succ, fail )
+//	swap id c1 c2 [to]			define_swap( c1, c2, to )
+//	stock id flower [n]			put() n flowers, or until the queue is full ( WhRose, .. )
+//	tester id flower [n]			put_tester() of hybridTest
+//	goal id ...				a regression trial ends with a flower in the goal fields
+//	until n					simulate() ends with n flowers in them ( default 10 )
+// -----------------------------------------------------------------------------
+struct pipeline
+{
+	struct field_def
+	{
+		std::string	id;
+		std::string	kind;
+		unsigned	units;
+		flowerColor	c[ 2 ];
+		std::string	title;
+		unsigned	line;
+	};
+	struct route_def
+	{
+		enum { Harvest, Test, Swap }	op;
+		std::string	from;
+		flowerColor	c[ 2 ];
+		std::string	to;		// Swap: empty for a swap in place
+		std::string	fail;		// Test
+		unsigned	line;
+	};
+	struct stock_def
+	{
+		std::string	to;
+		flower		f;
+		unsigned	n;		// 0: until the queue is full
+		bool		tester;
+		unsigned	line;
+	};
+
+	std::string			path;
+	std::string			title;
+	std::vector<field_def>		fields;
+	std::vector<route_def>		routes;
+	std::vector<stock_def>		stocks;
+	std::vector<std::string>	goals;
+	unsigned			goal_line = 0;
+	unsigned			until = 10;
+
+	bool load( const char* path );
+
+	int find( const std::string& id ) const
+	{
+		for ( unsigned i = 0; i < fields.size(); ++i ) {
+			if ( fields[ i ].id == id ) return i;
+		}
+		return -1;
+	}
+	bool error( unsigned line, const char* fmt, ... ) const;
+};
+
+// the flowers of the shops and the islands by name
+struct pipeline_flower
+{
+	const char*	name;
+	flowerType	type;
+	gene		g;
+};
+
+const pipeline_flower	pipeline_flowers[] = {
+	{ "WhRose",     Ro, gWhRose },     { "YeRose",     Ro, gYeRose },     { "RdRose",     Ro, gRdRose },
+	{ "PkRose",     Ro, gPkRose },     { "OrRose",     Ro, gOrRose },
+	{ "WhHyacinth", Hy, gWhHyacinth }, { "YeHyacinth", Hy, gYeHyacinth }, { "RdHyacinth", Hy, gRdHyacinth },
+	{ "PkHyacinth", Hy, gPkHyacinth }, { "OrHyacinth", Hy, gOrHyacinth }, { "BuHyacinth", Hy, gBuHyacinth },
+	{ "WhLily",     Li, gWhLily },     { "YeLily",     Li, gYeLily },     { "RdLily",     Li, gRdLily },
+	{ "PkLily",     Li, gPkLily },     { "OrLily",     Li, gOrLily },
+	{ "WhAnemone",  An, gWhAnemone },  { "OrAnemone",  An, gOrAnemone },  { "RdAnemone",  An, gRdAnemone },
+	{ "PkAnemone",  An, gPkAnemone },  { "BuAnemone",  An, gBuAnemone },
+	{ "WhPansie",   Pa, gWhPansie },   { "YePansie",   Pa, gYePansie },   { "RdPansie",   Pa, gRdPansie },
+	{ "BuPansie",   Pa, gBuPansie },   { "YRPansie",   Pa, gYRPansie },
+	{ "WhCosmos",   Co, gWhCosmos },   { "YeCosmos",   Co, gYeCosmos },   { "RdCosmos",   Co, gRdCosmos },
+	{ "PkCosmos",   Co, gPkCosmos },   { "OrCosmos",   Co, gOrCosmos },
+	{ "WhMum",      Ch, gWhMum },      { "YeMum",      Ch, gYeMum },      { "RdMum",      Ch, gRdMum },
+	{ "PuMum",      Ch, gPuMum },      { "PkMum",      Ch, gPkMum },
+	{ "WhTulip",    Tu, gWhTulip },    { "YeTulip",    Tu, gYeTulip },    { "RdTulip",    Tu, gRdTulip },
+	{ "PkTulip",    Tu, gPkTulip },    { "OrTulip",    Tu, gOrTulip },    { "BkTulip",    Tu, gBkTulip },
+};
+
+bool pipeline_flower_create( const char* name, flower& f )
+{
+	for ( const pipeline_flower& p : pipeline_flowers ) {
+		if ( strcmp( p.name, name ) != 0 ) continue;
+		switch ( p.type ) {
+			case Ro: f = rose::create( p.g ); break;
+			case Hy: f = hyacinth::create( p.g ); break;
+			case Li: f = lily::create( p.g ); break;
+			case An: f = anemone::create( p.g ); break;
+			case Pa: f = pansie::create( p.g ); break;
+			case Co: f = cosmos::create( p.g ); break;
+			case Ch: f = mum::create( p.g ); break;
+			case Tu: f = tulip::create( p.g ); break;
+			default: return false;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool pipeline_color( const std::string& s, flowerColor& c )
+{
+	for ( unsigned i = Wh; i <= Gl; ++i ) {
+		if ( s == colorString( static_cast<flowerColor>( i ))) {
+			c = static_cast<flowerColor>( i );
+			return true;
+		}
+	}
+	return false;
+}
+
+// member of pipeline
+// -----------------------------------------------------------------------------
+bool pipeline::error( unsigned line, const char* fmt, ... ) const
+{
+	va_list	ap;
+
+	fprintf( stderr, "Error: %s:%u: ", path.c_str(), line );
+	va_start( ap, fmt );
+	vfprintf( stderr, fmt, ap );
+	va_end( ap );
+	fprintf( stderr, "\n" );
+
+	return false;
+}
+
+bool pipeline::load( const char* p )
+{
+	FILE*		fp = fopen( p, "r" );
+	char		buf[ 1024 ];
+	unsigned	line = 0;
+	bool		ok = true;
+
+	path = p;
+	if ( !fp ) {
+		fprintf( stderr, "Error: cannot open %s\n", p );
+		return false;
+	}
+
+	while ( fgets( buf, sizeof( buf ), fp )) {
+		std::vector<std::string>	t;
+		const char*			s = buf;
+
+		++line;
+
+		// tokens, a quoted one may have spaces
+		while ( *s ) {
+			if ( isspace( *s )) {
+				++s;
+			} else if ( *s == '#' ) {
+				break;
+			} else if ( *s == '"' ) {
+				const char*	e = strchr( ++s, '"' );
+
+				if ( !e ) {
+					ok = error( line, "unterminated quote" );
+					break;
+				}
+				t.emplace_back( s, e - s );
+				s = e + 1;
+			} else {
+				const char*	e = s;
+
+				while ( *e && !isspace( *e ) && *e != '#' ) ++e;
+				t.emplace_back( s, e - s );
+				s = e;
+			}
+		}
+		if ( t.empty()) continue;
+
+		const std::string&	k = t[ 0 ];
+		const unsigned		n = t.size();
+
+		if ( k == "name" && n == 2 ) {
+			title = t[ 1 ];
+		} else if ( k == "field" && 4 <= n ) {
+			field_def	d = { t[ 1 ], t[ 2 ], (unsigned) strtoul( t[ 3 ].c_str(), nullptr, 0 ), { NA, NA }, t[ 1 ], line };
+			unsigned	i = 4;
+
+			for ( unsigned j = 0; j < 2 && i < n && pipeline_color( t[ i ], d.c[ j ] ); ++j ) ++i;
+			if ( i < n ) d.title = t[ i++ ];
+			if ( i < n )		   ok = error( line, "too many words of field %s", d.id.c_str());
+			else if ( find( d.id ) < 0 ) fields.push_back( d );
+			else			   ok = error( line, "field %s is defined twice", d.id.c_str());
+		} else if ( k == "harvest" && n == 4 ) {
+			route_def	r = { route_def::Harvest, t[ 1 ], { NA, NA }, t[ 3 ], "", line };
+
+			if ( !pipeline_color( t[ 2 ], r.c[ 0 ] )) ok = error( line, "unknown color %s", t[ 2 ].c_str());
+			routes.push_back( r );
+		} else if ( k == "test" && n == 5 ) {
+			route_def	r = { route_def::Test, t[ 1 ], { NA, NA }, t[ 3 ], t[ 4 ], line };
+
+			if ( !pipeline_color( t[ 2 ], r.c[ 0 ] )) ok = error( line, "unknown color %s", t[ 2 ].c_str());
+			routes.push_back( r );
+		} else if ( k == "swap" && ( n == 4 || n == 5 )) {
+			route_def	r = { route_def::Swap, t[ 1 ], { NA, NA }, ( n == 5 ) ? t[ 4 ] : "", "", line };
+
+			if ( !pipeline_color( t[ 2 ], r.c[ 0 ] )) ok = error( line, "unknown color %s", t[ 2 ].c_str());
+			if ( !pipeline_color( t[ 3 ], r.c[ 1 ] )) ok = error( line, "unknown color %s", t[ 3 ].c_str());
+			routes.push_back( r );
+		} else if (( k == "stock" || k == "tester" ) && ( n == 3 || n == 4 )) {
+			stock_def	d = { t[ 1 ], flower(), ( n == 4 ) ? (unsigned) strtoul( t[ 3 ].c_str(), nullptr, 0 ) : 0, k == "tester", line };
+
+			if ( !pipeline_flower_create( t[ 2 ].c_str(), d.f )) ok = error( line, "unknown flower %s", t[ 2 ].c_str());
+			stocks.push_back( d );
+		} else if ( k == "goal" && 2 <= n ) {
+			goals.insert( goals.end(), t.begin() + 1, t.end());
+			goal_line = line;
+		} else if ( k == "until" && n == 2 ) {
+			until = strtoul( t[ 1 ].c_str(), nullptr, 0 );
+		} else {
+			ok = error( line, "unknown definition or wrong number of words: %s", k.c_str());
+		}
+	}
+	fclose( fp );
+
+	// references to the fields
+	for ( const route_def& r : routes ) {
+		if ( find( r.from ) < 0 ) ok = error( r.line, "unknown field %s", r.from.c_str());
+		if ( !r.to.empty() && find( r.to ) < 0 ) ok = error( r.line, "unknown field %s", r.to.c_str());
+		if ( !r.fail.empty() && find( r.fail ) < 0 ) ok = error( r.line, "unknown field %s", r.fail.c_str());
+	}
+	for ( const stock_def& s : stocks ) {
+		if ( find( s.to ) < 0 ) ok = error( s.line, "unknown field %s", s.to.c_str());
+	}
+	for ( const std::string& g : goals ) {
+		if ( find( g ) < 0 ) ok = error( goal_line, "unknown goal field %s", g.c_str());
+	}
+	if ( fields.empty()) ok = error( line, "no field" );
+	if ( goals.empty())  ok = error( line, "no goal" );
+	if ( title.empty())  title = path;
+
+	return ok;
+}
+
+// Simulator of a pipeline
+//	the fields are the classes of acnh.h, and the I/F of each class ( define_harvest(),
+//	define_test(), define_swap() and put_tester()) is bound if the class has it, then a
+//	definition which the class does not have is an error of the file.
+//	the field units are the peak of the fields which have flowers, except the goals.
+// -----------------------------------------------------------------------------
+class PL_simulator : public simulator
+{
+	struct node
+	{
+		std::unique_ptr<ff_base>				field;
+		unsigned						units;
+		bool							goal = false;
+		std::function<void ( flowerColor, ff_base* )>		harvest;
+		std::function<void ( flowerColor, ff_base*, ff_base* )>	test;
+		std::function<void ( flowerColor, flowerColor, ff_base* )>	swap;
+		std::function<bool ( const flower& )>			put_tester;
+	};
+
+	std::shared_ptr<const pipeline>	m_def;
+	std::vector<node>		m_nodes;	// in the order of m_list
+	unsigned			m_fmax;
+	unsigned			m_units;	// peak of the field units in the trial
+	unsigned			m_firstGoal;
+
+	// the I/F of the class F, if it has
+	template <typename F>
+	static auto bind_harvest( node& n, F* p, int ) -> decltype( p->define_harvest( NA, nullptr ), void())
+	{
+		n.harvest = [p]( flowerColor c, ff_base* f ) { p->define_harvest( c, f ); };
+	}
+	template <typename F> static void bind_harvest( node&, F*, long ) { }
+
+	template <typename F>
+	static auto bind_test( node& n, F* p, int ) -> decltype( p->define_test( NA, nullptr, nullptr ), p->put_tester( flower()), void())
+	{
+		n.test       = [p]( flowerColor c, ff_base* s, ff_base* f ) { p->define_test( c, s, f ); };
+		n.put_tester = [p]( const flower& f ) { return p->put_tester( f ); };
+	}
+	template <typename F> static void bind_test( node&, F*, long ) { }
+
+	template <typename F>
+	static auto bind_swap( node& n, F* p, int ) -> decltype( p->define_swap( NA, NA, nullptr ), void())
+	{
+		n.swap = [p]( flowerColor c1, flowerColor c2, ff_base* f ) { p->define_swap( c1, c2, f ); };
+	}
+	template <typename F> static void bind_swap( node&, F*, long ) { }
+
+	template <typename F>
+	static void bind( node& n, F* p, unsigned units )
+	{
+		n.field.reset( p );
+		n.units = units;
+		bind_harvest( n, p, 0 );
+		bind_test( n, p, 0 );
+		bind_swap( n, p, 0 );
+	}
+
+	// 5 x C fields by the units 1..5
+	template <template <unsigned> class F, typename... A>
+	static bool make_5xC( node& n, unsigned u, A... a )
+	{
+		switch ( u ) {
+			case 1: bind( n, new F<3>( a... ), u ); return true;
+			case 2: bind( n, new F<7>( a... ), u ); return true;
+			case 3: bind( n, new F<11>( a... ), u ); return true;
+			case 4: bind( n, new F<15>( a... ), u ); return true;
+			case 5: bind( n, new F<19>( a... ), u ); return true;
+		}
+		return false;
+	}
+
+	static bool make( const pipeline::field_def& d, node& n )
+	{
+		const char*	t = d.title.c_str();
+
+		if ( d.kind == "storage" )	 return make_5xC<ff_storage>( n, d.units, t );
+		if ( d.kind == "isolated" )	 return make_5xC<ff_isolated>( n, d.units, t );
+		if ( d.kind == "selfHybrid" )	 return make_5xC<ff_selfHybrid>( n, d.units, t );
+		if ( d.kind == "initialHybrid" ) return make_5xC<ff_initialHybrid>( n, d.units, t );
+		if ( d.kind == "pairHybrid" )	 return make_5xC<ff_pairHybrid>( n, d.units, t, d.c[ 0 ], d.c[ 1 ] );
+		if ( d.kind == "lineHybrid" )	 return make_5xC<ff_lineHybrid>( n, d.units, t, d.c[ 0 ], d.c[ 1 ] );
+		if ( d.kind == "swapHybrid" ) {
+			switch ( d.units ) {
+				case 2: bind( n, new ff_swapHybrid_2( t, d.c[ 0 ] ), 2 ); return true;
+				case 3: bind( n, new ff_swapHybrid_3( t, d.c[ 0 ] ), 3 ); return true;
+				case 6: bind( n, new ff_swapHybrid_6( t, d.c[ 0 ] ), 6 ); return true;
+			}
+			return false;
+		}
+		if ( d.kind == "hybridTest" ) {
+			switch ( d.units ) {
+				case 2:  bind( n, new ff_hybridTest_2( t ), 2 ); return true;
+				case 4:  bind( n, new ff_hybridTest_4( t ), 4 ); return true;
+				case 6:  bind( n, new ff_hybridTest_6( t ), 6 ); return true;
+				case 8:  bind( n, new ff_hybridTest_8( t ), 8 ); return true;
+				case 10: bind( n, new ff_hybridTest_10( t ), 10 ); return true;
+			}
+			return false;
+		}
+		return false;
+	}
+
+	// build the fields and the routes of m_def, false if the file defines what the classes do not have
+	bool build()
+	{
+		const pipeline&	p = *m_def;
+		bool		ok = true;
+
+		m_nodes.resize( p.fields.size());
+		for ( unsigned i = 0; i < p.fields.size(); ++i ) {
+			const pipeline::field_def&	d = p.fields[ i ];
+
+			if ( !make( d, m_nodes[ i ] )) {
+				ok = p.error( d.line, "no field of kind %s and %u units", d.kind.c_str(), d.units );
+				continue;
+			}
+			m_list.push_back( m_nodes[ i ].field.get());
+		}
+		if ( !ok ) return false;
+
+		for ( const pipeline::route_def& r : p.routes ) {
+			const pipeline::field_def&	d = p.fields[ p.find( r.from ) ];
+			node&				n = m_nodes[ p.find( r.from ) ];
+			ff_base*			to = r.to.empty() ? nullptr : m_nodes[ p.find( r.to ) ].field.get();
+
+			switch ( r.op ) {
+				case pipeline::route_def::Harvest:
+					// ff_lineHybrid keeps c1 in the field
+					if ( !n.harvest || ( d.kind == "lineHybrid" && r.c[ 0 ] == d.c[ 0 ] ))
+						ok = p.error( r.line, "%s cannot harvest %s", d.id.c_str(), colorString( r.c[ 0 ] ));
+					else
+						n.harvest( r.c[ 0 ], to );
+					break;
+				case pipeline::route_def::Test:
+					if ( !n.test ) ok = p.error( r.line, "%s is not a test field", d.id.c_str());
+					else	       n.test( r.c[ 0 ], to, m_nodes[ p.find( r.fail ) ].field.get());
+					break;
+				case pipeline::route_def::Swap:
+					if ( !n.swap ) ok = p.error( r.line, "%s is not a swap field", d.id.c_str());
+					else	       n.swap( r.c[ 0 ], r.c[ 1 ], to );
+					break;
+			}
+		}
+		for ( const pipeline::stock_def& s : p.stocks ) {
+			if ( s.tester && !m_nodes[ p.find( s.to ) ].put_tester ) ok = p.error( s.line, "%s is not a test field", s.to.c_str());
+		}
+		for ( const std::string& g : p.goals ) m_nodes[ p.find( g ) ].goal = true;
+
+		return ok;
+	}
+
+	PL_simulator( const std::shared_ptr<const pipeline>& p ) : m_def( p ), m_fmax( 0 ), m_units( 0 ), m_firstGoal( 0 ) { }
+
+    public:
+	~PL_simulator() { }
+
+	// nullptr if the file has an error
+	static PL_simulator* create( const std::shared_ptr<const pipeline>& p )
+	{
+		PL_simulator*	s = new PL_simulator( p );
+
+		if ( s->build()) return s;
+		delete s;
+
+		return nullptr;
+	}
+	static PL_simulator* from_file( const char* path )
+	{
+		std::shared_ptr<pipeline>	p = std::make_shared<pipeline>();
+
+		return p->load( path ) ? create( p ) : nullptr;
+	}
+
+	const char* title() const { return m_def->title.c_str(); }
+	const char* path() const { return m_def->path.c_str(); }
+
+	void initialize() override
+	{
+		m_units = 0;
+
+		for ( const pipeline::stock_def& s : m_def->stocks ) {
+			node&	n = m_nodes[ m_def->find( s.to ) ];
+
+			for ( unsigned i = 0; s.n == 0 || i < s.n; ++i ) {
+				if ( !( s.tester ? n.put_tester( s.f ) : n.field->put( s.f ))) break;
+			}
+		}
+	}
+	bool terminate_sim() override
+	{
+		if ( m_firstGoal == 0 && goals() != 0 ) m_firstGoal = m_step;
+
+		return m_def->until <= goals();
+	}
+	bool terminate_reg() override
+	{
+		unsigned n = usingFields();
+
+		if ( m_fmax < n ) m_fmax = n;
+		if ( m_units < n ) m_units = n;
+
+		return 0 < goals();
+	}
+	void print() override
+	{
+		unsigned	n = usingFields();
+
+		if ( m_fmax < n ) m_fmax = n;
+
+		fprintf( stderr, "\n*** step %u *** ( %u fields )\n", m_step, n );
+		for ( const node& d : m_nodes ) {
+			if ( d.field->count() != 0 ) d.field->print( bool( d.test ));
+		}
+	}
+
+	simulator* clone() const override { return create( m_def ); }
+	void merge( const simulator& s ) override
+	{
+		unsigned n = static_cast<const PL_simulator&>( s ).m_fmax;
+
+		if ( m_fmax < n ) m_fmax = n;
+	}
+	bool save( FILE* fp ) const override { return fwrite( &m_fmax, sizeof( m_fmax ), 1, fp ) == 1; }
+	bool load( FILE* fp ) override { return fread( &m_fmax, sizeof( m_fmax ), 1, fp ) == 1; }
+	void save_state( snapshot& s ) const override
+	{
+		simulator::save_state( s );
+		s.put( m_firstGoal );
+		s.put( m_units );
+	}
+	void load_state( snapshot& s ) override
+	{
+		simulator::load_state( s );
+		s.get( m_firstGoal );
+		s.get( m_units );
+	}
+
+	unsigned maxFieldUnits() const { return m_fmax; }
+	unsigned firstGoal() const { return m_firstGoal; }
+
+	void record( trial_record& r ) const override
+	{
+		r.first_blue  = ( goals() != 0 ) ? m_step : 0;
+		r.field_units = m_units;
+	}
+
+    private:
+	unsigned goals() const
+	{
+		unsigned	n = 0;
+
+		for ( const node& d : m_nodes ) {
+			if ( d.goal ) n += d.field->count();
+		}
+		return n;
+	}
+	unsigned usingFields() const
+	{
+		unsigned	n = 0;
+
+		for ( const node& d : m_nodes ) {
+			if ( !d.goal && d.field->count() != 0 ) n += d.units;
+		}
+		return n;
+	}
+};
+
+#endif // PIPELINE_H
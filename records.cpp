@@ -0,0 +1,89 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	reader of the trial records ( --record file )
+//
+
+#include <acnh.h>
+
+// CSV export
+// -----------------------------------------------------------------------------
+void export_csv( record_file& f, FILE* fp )
+{
+	unsigned long long		seed;
+	std::vector<trial_record>	r;
+
+	fprintf( fp, "seed" );
+	for ( unsigned k = 0; k < trial_record::Columns; ++k ) fprintf( fp, ",%s", trial_record::column_name( k ));
+	fprintf( fp, "\n" );
+
+	while ( f.read( seed, r )) {
+		for ( const trial_record& t : r ) {
+			fprintf( fp, "%llu", seed );
+			for ( unsigned k = 0; k < trial_record::Columns; ++k ) fprintf( fp, ",%u", t.*trial_record::column( k ));
+			fprintf( fp, "\n" );
+		}
+	}
+}
+
+// summary
+// -----------------------------------------------------------------------------
+void summary( record_file& f, unsigned maxsteps, FILE* fp )
+{
+	unsigned long long		seed;
+	std::vector<trial_record>	r;
+	step_stat			steps( maxsteps );
+	step_stat			units( maxsteps );
+	unsigned			blocks = 0;
+	unsigned long long		last = 0;
+
+	while ( f.read( seed, r )) {
+		if ( blocks++ == 0 || seed != last ) fprintf( fp, "seed %llu\n", seed );
+		last = seed;
+		for ( const trial_record& t : r ) {
+			steps.add( t.steps );
+			units.add( t.field_units );
+		}
+	}
+	fprintf( fp, "%u traials, ", steps.count());
+	steps.print( "", fp );
+	fprintf( fp, "field units: " );
+	units.print( "", fp );
+}
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	bool		csv = false;
+	unsigned	maxsteps = DefaultMaxSteps;
+	int		files = 0;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'c': csv = true; break;
+				case 'm': maxsteps = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				default:
+					fprintf( stderr, "Usage: %s [-c][-m maxstep] file ...\n", argv[ 0 ] );
+					return -1;
+			}
+		} else {
+			record_file	f;
+
+			if ( !f.open( argv[ i ] )) return 1;
+			if ( csv ) export_csv( f, stdout );
+			else	   summary( f, maxsteps, stdout );
+			if ( f.failed()) return 1;
+			++files;
+		}
+	}
+	if ( files == 0 ) {
+		fprintf( stderr, "Usage: %s [-c][-m maxstep] file ...\n", argv[ 0 ] );
+		return -1;
+	}
+
+	return 0;
+}
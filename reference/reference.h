@@ -0,0 +1,90 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	frozen reference engine of the differential test ( differ.cpp )
+//
+//	acnh.h, layout1.cpp, layout2.cpp, bn.cpp and grx.cpp of the baseline ( d599733 ) in the
+//	namespace ref: the flowers are objects by pointers, cross() tests the bits of rand(), the
+//	process order is sorted by rand() keys and the neighbors are scanned. the files are kept
+//	as they were, except that the main()s are removed, std::rand() is rand() of the engine
+//	bound below, and the lines marked "differ" tally the hybrids and the harvests.
+//
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <acnh.h>
+
+namespace ref {
+
+// rand() of the baseline, 31 bits of the random_engine bound to the thread
+thread_local random_engine*	ref_rng = nullptr;
+
+inline int rand() { return (int)(( *ref_rng )() >> 33 ); }
+inline void bind( random_engine* e ) { ref_rng = e; }
+
+// hybrids and harvests of the frozen fields, for the clone rates, the genotypes and the harvest counts
+struct tally
+{
+	unsigned long long	prods = 0;
+	unsigned long long	clones = 0;
+	unsigned long long	harvests = 0;
+	unsigned long long	genotype[ Genotypes ] = {};	// by flower::flower_no()
+
+	void hybrid( gene g, bool clone )
+	{
+		++prods;
+		if ( clone ) ++clones;
+		++genotype[ flower::flower_no( g ) ];
+	}
+};
+
+thread_local tally	ref_tally;
+
+#include "acnh.h"
+
+namespace layout1 {
+#include "layout1.cpp"
+}
+namespace layout2 {
+#include "layout2.cpp"
+}
+namespace bn {
+#include "bn.cpp"
+}
+namespace grx {
+#include "grx.cpp"
+}
+
+// one trial of the simulator S as the baseline regression() runs it, without the output
+template <typename S>
+class trial_of : public S
+{
+    public:
+	unsigned trial( random_engine& e )
+	{
+		bind( &e );
+		this->initialize();
+
+		this->m_step = 0;
+		do {
+			if ( this->m_maxsteps < ++this->m_step ) {
+				fprintf( stderr, "Error: over %u steps\n", this->m_maxsteps );
+				exit( 1 );
+			}
+			this->step();
+		}
+		while ( !this->terminate_reg());
+
+		this->finalize();
+
+		for ( ff_base* p : this->m_list ) p->recycle();
+		flower::clear_pool();
+
+		return this->m_step;
+	}
+};
+
+} // namespace ref
+
+#endif // REFERENCE_H
@@ -0,0 +1,90 @@
+//
+// Animal Crossing New Horizon - Plant Hybrid Simulator
+//
+//	replay of the event trace ( --trace file )
+//
+
+#include "methods.h"
+
+// render the events as the text of the verbose mode, or the counts of the events
+// -----------------------------------------------------------------------------
+void render( trace_file& f, bool all, FILE* fp )
+{
+	trace_event	e;
+	unsigned	n = 0;
+
+	fprintf( fp, "Info: seed %llu, trial %u\n", f.seed(), f.trial());
+	while ( f.get( e )) {
+		e.print( f.name( e.field ), f.name( e.aux ), all, fp );
+		++n;
+	}
+	if ( all ) fprintf( fp, "Info: %u events\n", n );
+}
+
+void count( trace_file& f, FILE* fp )
+{
+	trace_event	e;
+	trace_count	c;
+
+	fprintf( fp, "Info: seed %llu, trial %u\n", f.seed(), f.trial());
+	while ( f.get( e )) c.put( f.name( e.field ), e );
+	c.print( fp );
+}
+
+//
+// main
+//
+// -----------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	sim_options	opt;
+	unsigned	visitor = 0;
+	bool		all  = false;
+	bool		cnt  = false;
+	const char*	path = "replay.trc";
+	const char*	name = nullptr;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( *argv[ i ] == '-' ) {
+			switch ( *( argv[ i ] + 1 )) {
+				case 'a': all     = true; break;
+				case 'c': cnt     = true; break;
+				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case 'o': path    = argv[ ++i ]; break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
+				default:
+					fprintf( stderr, "Usage: %s [-a|-c] file\n", argv[ 0 ] );
+					fprintf( stderr, "       %s [-a|-c][-v visitors][-o file]%s method\n", argv[ 0 ], sim_options::usage());
+					fprintf( stderr, "       method: bn, bn_lite, ph, gr, grx\n" );
+					return -1;
+			}
+		} else {
+			name = argv[ i ];
+		}
+	}
+	if ( !name ) {
+		fprintf( stderr, "Error: a trace file or a method is required\n" );
+		return -1;
+	}
+
+	// re-simulate the trial ( --seed, --trial ) of the method to the trace
+	if ( const method* m = find_method( name )) {
+		simulator*	s = m->create();
+
+		s->set_visitor( visitor );
+		s->set_options( opt );
+		s->trace_trial( opt.trial, path );
+		delete s;
+
+		name = path;
+	}
+
+	trace_file	f;
+
+	if ( !f.open( name )) return 1;
+	if ( cnt ) count( f, stdout );
+	else	   render( f, all, stdout );
+
+	return 0;
+}
@@ -45,6 +45,7 @@ class FR_simulator : public simulator
 		}
 	}
 	bool terminate_reg() { return terminate_sim(); } 
+	simulator* clone() const { return new FR_simulator( m_target ); }
 	void print()
 	{
 		fprintf( stderr, "\n*** step %u *** ( %u )\n", m_step, m_f.prods() );
@@ -52,17 +53,18 @@ class FR_simulator : public simulator
 	}
 };
 
+#ifndef ACNH_NO_MAIN
 //
 // main
 // 
 // -----------------------------------------------------------------------------
 int main( int argc, char** argv )
 {
-	std::srand( std::time(nullptr) );
-
+	sim_options	opt;
 	unsigned	visitor = 0;
 	unsigned	targets = 1;
 	unsigned	repeats = 1000;
+	unsigned	jobs    = 1;
 	bool		simulate = false;
 	
 	for ( int i = 1; i < argc; ++i ) {
@@ -71,8 +73,11 @@ int main( int argc, char** argv )
 				case 'v': visitor = strtoul( argv[ ++i ], nullptr, 0 ); break;
 				case 't': targets = strtoul( argv[ ++i ], nullptr, 0 ); break;
 				case 's': simulate = true; break;
+				case 'j': jobs    = strtoul( argv[ ++i ], nullptr, 0 ); break;
+				case '-': if ( opt.parse( argc, argv, i )) break;
+					  // fall through
 				default:
-					fprintf( stderr, "Usage: %s [-v visitors][-t clones][-s] [regressions]\n", argv[ 0 ] );
+					fprintf( stderr, "Usage: %s [-v visitors][-t clones][-s][-j jobs] [regressions]%s\n", argv[ 0 ], sim_options::usage());
 					exit( 1 );
 			}
 		} else {
@@ -83,16 +88,17 @@ int main( int argc, char** argv )
 	FR_simulator	s( targets );
 
 	s.set_visitor( visitor );
+	s.set_options( opt );
 
 	if ( simulate ) {
 		unsigned	n = s.simulate();
 
 		printf( "\nFlower Reproduction: %u steps for %u clones.\n", n, targets );
 	} else {
-		s.regression( repeats );
+		repeats = s.regression( repeats, jobs );
 		printf( "\nFlower Reproduction: %u regressions, target %u flower created.\n", repeats, targets );
 	}
 
 	return 0;
 }
-
+#endif // ACNH_NO_MAIN